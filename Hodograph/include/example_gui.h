@@ -3,9 +3,17 @@
 
 #include "gui/gui.h"
 
+#include <kinematics/hodograph_cache.h>
+#include <filters/derivative_filter.h>
+#include <linkage/linkage_mechanism.h>
+#include <profiling/profiler.h>
+#include <statistics/phase_density.h>
+
 #include <memory>
+#include <vector>
 
 class HodographSimulation;
+struct SummaryStatistics;
 
 namespace ifx{
 class EngineGUI;
@@ -26,15 +34,44 @@ public:
 private:
     void RenderHodographWindow();
     void RenderSimulationInfo();
+    void RenderKinematicsThread();
+    void RenderRunningStatistics();
+    void RenderProfiler();
     void RenderProperties();
+    void RenderDerivativeFilter(FilterSettings& filter);
+    void RenderMechanism(MechanismSettings& mechanism);
+    void RenderSpectrum();
+    void RenderSpectrumChannel(const char* label, HodographChannel channel);
+    void RenderEnsemble();
+    void RenderTrace();
+    void RenderEnsembleStatistics(const char* label,
+                                  const SummaryStatistics& statistics,
+                                  const float* history_mean);
 
     void RenderGraphs();
     void RenderPositionGraphs();
+    void RenderHistoryPlot(const char* label,
+                           HodographChannel channel,
+                           const char* overlay,
+                           std::size_t begin, std::size_t end);
+    void RenderReplayGraphs();
+    void RenderHistoryCapacity();
+    void RenderFullHistory();
+    void RenderFullHistoryPlot(const char* label, HodographChannel channel,
+                               const char* overlay);
     void RenderPhaseonGraphs();
+    void RenderDerivativeDiagnostics();
+    void RenderSensitivities();
+    void RenderCycles();
 
     std::shared_ptr<ifx::EngineGUI> engine_gui_;
     std::shared_ptr<HodographSimulation> hodograph_simulation_;
 
+    std::vector<MinMax> plot_columns_;
+    std::vector<DensityRun> density_runs_;
+    std::vector<ProfileEvent> profile_events_;
+    std::vector<StageStatistics> stage_statistics_;
+
 };
 
 
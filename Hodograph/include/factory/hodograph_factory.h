@@ -1,20 +1,42 @@
 #ifndef PROJECT_HODOGRAPH_FACTORY_H
 #define PROJECT_HODOGRAPH_FACTORY_H
 
+#include <factory/hodograph_resources.h>
+
 #include <memory>
 
 namespace ifx{
 class GameObject;
 }
 
+/**
+ * Creates the game objects of a mechanism. Programs, materials and meshes
+ * come from HodographResources, so factories sharing one resources
+ * instance share their GL objects.
+ */
 class HodographFactory {
 public:
 
-    HodographFactory();
+    HodographFactory(std::shared_ptr<HodographResources> resources
+                     = HodographResources::Shared());
     ~HodographFactory();
 
+    std::shared_ptr<HodographResources> resources() {return resources_;}
+
+    /**
+     * Builds every resource CreateCircle and CreateBox use, call it right
+     * after the window so the first frame does not wait for shaders.
+     */
+    void WarmUp();
+
     std::shared_ptr<ifx::GameObject> CreateCircle();
     std::shared_ptr<ifx::GameObject> CreateBox();
+
+private:
+    std::shared_ptr<ifx::GameObject> Create(ResourceMesh mesh,
+                                            const glm::vec3& color);
+
+    std::shared_ptr<HodographResources> resources_;
 };
 
 
@@ -0,0 +1,59 @@
+#ifndef PROJECT_HODOGRAPH_RESOURCES_H
+#define PROJECT_HODOGRAPH_RESOURCES_H
+
+#include <math/math_ifx.h>
+
+#include <map>
+#include <memory>
+#include <tuple>
+
+namespace ifx{
+class Program;
+class Model;
+struct Material;
+}
+
+enum class ResourceMesh{
+    CIRCLE, QUAD
+};
+
+/**
+ * GL resources shared by every object HodographFactory creates, built on
+ * first use and keyed by what tells them apart:
+ *  program   - one main program.
+ *  materials - one solid color diffuse/specular pair per color.
+ *  models    - one mesh per (shape, color), the mesh holds its material.
+ *
+ * Adding a mechanism with known colors to a scene creates no new shaders,
+ * textures or buffers. All calls create GL objects and must run on the
+ * thread that owns the context.
+ */
+class HodographResources{
+public:
+    HodographResources();
+    ~HodographResources();
+
+    /**
+     * Instance used by factories that are not given their own.
+     */
+    static std::shared_ptr<HodographResources> Shared();
+
+    std::shared_ptr<ifx::Program> program();
+    std::shared_ptr<ifx::Material> material(const glm::vec3& color);
+    std::shared_ptr<ifx::Model> model(ResourceMesh mesh,
+                                      const glm::vec3& color);
+
+    int program_count() const {return program_ ? 1 : 0;}
+    int material_count() const {return (int)materials_.size();}
+    int model_count() const {return (int)models_.size();}
+
+private:
+    typedef std::tuple<float, float, float> ColorKey;
+    typedef std::tuple<int, float, float, float> ModelKey;
+
+    std::shared_ptr<ifx::Program> program_;
+    std::map<ColorKey, std::shared_ptr<ifx::Material>> materials_;
+    std::map<ModelKey, std::shared_ptr<ifx::Model>> models_;
+};
+
+#endif //PROJECT_HODOGRAPH_RESOURCES_H
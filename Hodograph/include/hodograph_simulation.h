@@ -4,8 +4,18 @@
 #include <vr/simulation.h>
 
 #include <math/math_ifx.h>
+#include <kinematics/hodograph_cache.h>
+#include <kinematics/hodograph_ensemble.h>
+#include <threading/kinematics_thread.h>
+#include <trace/trace_reader.h>
+#include <trace/trace_writer.h>
+#include <telemetry/telemetry_publisher.h>
+#include <containers/ring_buffer.h>
+#include <spectrum/spectrum_analyzer.h>
+#include <statistics/hodograph_statistics.h>
+#include <statistics/phase_density.h>
+#include <history/compressed_history.h>
 
-#include <random>
 #include <memory>
 
 namespace ifx{
@@ -16,26 +26,20 @@ class SceneContainer;
 struct HodographGameObjects{
     std::shared_ptr<ifx::GameObject> circle;
     std::shared_ptr<ifx::GameObject> box;
+    /**
+     * Unit segment from (0,0,0) to (0,0,1), created once and mapped onto
+     * the connecting rod through its transform.
+     */
+    std::shared_ptr<ifx::GameObject> line;
 };
 
-struct Line {
-    glm::vec3 position0;
-    glm::vec3 position1;
-
-    glm::vec3 last_position1;
-    glm::vec3 last_last_position1;
-
-    std::shared_ptr<ifx::GameObject> game_object = nullptr;
-};
-
-struct HodographCache{
-    std::vector<glm::vec3> positions;
-    std::vector<glm::vec3> velocities;
-    std::vector<glm::vec3> accelerations;
-
-    std::vector<float> positions_z;
-    std::vector<float> velocities_z;
-    std::vector<float> accelerations_z;
+struct SpectrumSettings{
+    int harmonics = SpectrumAnalyzer::DEFAULT_HARMONICS;
+    int fft_size = 4096;
+    /**
+     * Seconds between two FFT updates.
+     */
+    float fft_period = 0.5f;
 };
 
 class HodographSimulation : public ifx::Simulation {
@@ -46,55 +50,152 @@ public:
                         std::shared_ptr<ifx::SceneContainer> scene);
     ~HodographSimulation();
 
-    float* angular_velocity(){return &angular_velocity_;}
-    float* radius(){return &radius_;}
-    float* line_length(){return &line_length_;}
-    float* error(){return &error_;}
+    float* angular_velocity(){return &settings_.parameters.angular_velocity;}
+    float* radius(){return &settings_.parameters.radius;}
+    float* line_length(){return &settings_.parameters.line_length;}
+    float* error(){return &settings_.parameters.error;}
 
-    float line_error_length(){return line_error_length_;}
-    float alpha(){return alpha_;}
+    /**
+     * Edited by the GUI, sent to the kinematics thread on the next Update.
+     */
+    HodographSettings& settings(){return settings_;}
+
+    float line_error_length(){return frame_.line_error_length;}
+    float alpha(){return frame_.alpha;}
+    const HodographFrame& frame(){return frame_;}
     HodographCache& hodograph_cache(){return hodograph_cache_;}
+    /**
+     * Every valid step since the last ResetCache, fast-forwarded ones
+     * included, see KinematicsThread::ReadStatistics. Unlike the cache not
+     * limited by its capacity.
+     */
+    const HodographStatistics& statistics(){return statistics_;}
+    /**
+     * Slider (position, velocity) of every received frame with a valid
+     * sample, only every fast_forward-th step.
+     */
+    const PhaseDensity& phase_density(){return phase_density_;}
+    KinematicsThread& kinematics_thread(){return kinematics_thread_;}
+
+    /**
+     * Lossless compressed copy of every frame since it was enabled or the
+     * last ResetCache. Allocates a chunk every CHUNK_SIZE frames.
+     */
+    const CompressedHistory& full_history(){return full_history_;}
+    bool full_history_enabled(){return full_history_enabled_;}
+    void full_history_enabled(bool value);
+
+    HodographEnsemble& ensemble(){return ensemble_;}
+    const RingBuffer<EnsembleStep>& ensemble_history(){
+        return ensemble_history_;}
+    bool ensemble_enabled(){return ensemble_enabled_;}
+    void ensemble_enabled(bool value);
+    void ResetEnsemble(std::size_t size);
+
+    const RingBuffer<HodographSample>& derivative_difference_history(){
+        return derivative_difference_history_;}
+    const RingBuffer<HodographSensitivity>& sensitivity_history(){
+        return sensitivity_history_;}
+    /**
+     * One record per crank revolution since the last ResetCache.
+     */
+    const RingBuffer<CycleRecord>& cycle_history(){return cycle_history_;}
+
+    const SpectrumAnalyzer& spectrum(){return spectrum_;}
+    SpectrumSettings& spectrum_settings(){return spectrum_settings_;}
+    bool spectrum_enabled(){return spectrum_enabled_;}
+    void spectrum_enabled(bool value);
+
+    /**
+     * Heap allocations made by the last Update, expected to be 0.
+     */
+    unsigned long long update_allocations(){return update_allocations_;}
 
     void Update() override;
 
     void ResetCache();
+
+    /**
+     * Restarts the kinematics from alpha = 0 and clears the history.
+     */
+    void ResetKinematics();
+
+    /**
+     * Appends every frame received from the kinematics thread to a trace
+     * file. The file is written by a background thread.
+     */
+    bool StartRecording(const std::string& path);
+    void StopRecording();
+    TraceWriter& trace_writer(){return trace_writer_;}
+
+    /**
+     * Publishes every received frame to a shared memory ring that other
+     * processes read with TelemetryReader or hodograph_tail.
+     */
+    bool StartTelemetry(const std::string& name);
+    void StopTelemetry();
+    TelemetryPublisher& telemetry(){return telemetry_;}
+
+    /**
+     * Maps a trace file and plays it back instead of the kinematics thread.
+     */
+    bool StartReplay(const std::string& path);
+    void StopReplay();
+    TraceReader& trace_reader(){return trace_reader_;}
+    bool is_replaying(){return trace_reader_.is_open();}
+    std::size_t* replay_cursor(){return &replay_cursor_;}
 private:
     void InitGameObjects();
+    void InitLineGameObject();
 
     void UpdateGameObjects();
     void UpdateCircleGameObject();
     void UpdateBoxGameObject();
     void UpdateLineGameObject();
 
-    void UpdateLine();
-    void UpdateErrorLine();
-    void UpdateLinePosition();
-    void UpdateLinePosition0();
-    void UpdateLinePosition1();
+    void UpdateSettings();
+    void UpdateFrames();
+    void UpdateReplay();
+    void UpdateEnsemble();
+    void UpdateSpectrum();
 
-    void UpdateAlpha();
-    void ClampAlpha();
+    KinematicsThread kinematics_thread_;
+    HodographSettings settings_;
+    HodographSettings sent_settings_;
 
-    void UpdateCache();
+    HodographFrame frame_;
+    HodographCache hodograph_cache_;
+    HodographStatistics statistics_;
+    PhaseDensity phase_density_;
 
-    float angular_velocity_;
-    float radius_;
-    float line_length_;
-    float error_;
-    float alpha_;
+    CompressedHistory full_history_;
+    bool full_history_enabled_;
 
-    float line_error_length_;
-    std::default_random_engine generator_;
+    TraceWriter trace_writer_;
+    TraceReader trace_reader_;
+    TelemetryPublisher telemetry_;
+    std::size_t replay_cursor_;
+    std::size_t last_replay_cursor_;
+    double replay_time_;
 
-    Line line_;
+    HodographEnsemble ensemble_;
+    RingBuffer<EnsembleStep> ensemble_history_;
+    bool ensemble_enabled_;
 
-    HodographCache hodograph_cache_;
+    RingBuffer<HodographSample> derivative_difference_history_;
+    RingBuffer<HodographSensitivity> sensitivity_history_;
+    RingBuffer<CycleRecord> cycle_history_;
+
+    SpectrumAnalyzer spectrum_;
+    SpectrumSettings spectrum_settings_;
+    bool spectrum_enabled_;
+    float fft_elapsed_;
 
     HodographGameObjects game_objects_;
 
     std::shared_ptr<ifx::SceneContainer> scene_;
 
-    bool is_first_iteration_;
+    unsigned long long update_allocations_;
 };
 
 #endif //PROJECT_HODOGRAPH_SIMULATION_H
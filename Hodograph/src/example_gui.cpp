@@ -6,6 +6,35 @@
 #include <physics/bullet_extensions/btFractureDynamicsWorld.h>
 #include <physics/simulations/bullet_physics_simulation.h>
 #include <hodograph_simulation.h>
+#include <memory/allocation_counter.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/**
+ * Stage statistics cover the events of the last second.
+ */
+const uint64_t PROFILE_WINDOW = 1000000000;
+
+float PlotMinMaxColumn(void* data, int i){
+    const MinMax& column = ((MinMax*)data)[i / 2];
+    return i % 2 == 0 ? column.min : column.max;
+}
+
+/**
+ * Harmonics 1..k, bin 0 (the mean) is printed instead.
+ */
+float PlotHarmonic(void* data, int i){
+    return ((const SlidingDft*)data)->Amplitude(i + 1);
+}
+
+const int FFT_SIZES[] = {1024, 2048, 4096, 8192, 16384};
+const char* FFT_SIZE_NAMES[] = {"1024", "2048", "4096", "8192", "16384"};
+const int FFT_SIZE_COUNT = 5;
+
+}
 
 ExampleGUI::ExampleGUI(GLFWwindow* window,
                        std::shared_ptr<ifx::SceneContainer> scene,
@@ -44,16 +73,35 @@ void ExampleGUI::RenderHodographWindow(){
         RenderGraphs();
         ImGui::TreePop();
     }
+    if(ImGui::TreeNode("Spectrum")){
+        RenderSpectrum();
+        ImGui::TreePop();
+    }
+    if(ImGui::TreeNode("Ensemble")){
+        RenderEnsemble();
+        ImGui::TreePop();
+    }
+    if(ImGui::TreeNode("Trace")){
+        RenderTrace();
+        ImGui::TreePop();
+    }
 
 }
 
 void ExampleGUI::RenderSimulationInfo(){
     ImGui::Text("FPS: %.1f", ImGui::GetIO().Framerate);
     ImGui::Text("Time: %.2f [s]", hodograph_simulation_->time_data().total_time);
+    if(AllocationCounter::enabled()){
+        ImGui::Text("Allocations per update: %llu",
+                    hodograph_simulation_->update_allocations());
+    }else{
+        ImGui::Text("Allocations per update: not counted");
+    }
 
     if (ImGui::Button("Reset")) {
         hodograph_simulation_->SetRunning(true);
         hodograph_simulation_->Reset();
+        hodograph_simulation_->ResetKinematics();
     }
     ImGui::SameLine();
 
@@ -66,6 +114,117 @@ void ExampleGUI::RenderSimulationInfo(){
     if (ImGui::Button(play_button_text.c_str())) {
         hodograph_simulation_->SetRunning(!hodograph_simulation_->IsRunning());
     }
+
+    const int factors[] = {1, 10, 100, 1000};
+    const char* factor_names[] = {"x1", "x10", "x100", "x1000"};
+    static int factor = 0;
+    if(ImGui::Combo("Fast Forward", &factor, factor_names, 4)){
+        hodograph_simulation_->kinematics_thread().SetFastForward(
+                factors[factor]);
+    }
+
+    RenderKinematicsThread();
+    RenderRunningStatistics();
+    RenderProfiler();
+}
+
+void ExampleGUI::RenderRunningStatistics(){
+    static int axis = static_cast<int>(Axis::Z);
+    const char* axes[] = {"x", "y", "z"};
+    ImGui::Combo("Statistics Axis", &axis, axes, AXIS_COUNT);
+
+    const char* channels[] = {"Position", "Velocity", "Acceleration"};
+    const HodographStatistics& statistics
+            = hodograph_simulation_->statistics();
+
+    ImGui::Columns(6, "running_statistics");
+    ImGui::Text("Channel"); ImGui::NextColumn();
+    ImGui::Text("Mean"); ImGui::NextColumn();
+    ImGui::Text("Std"); ImGui::NextColumn();
+    ImGui::Text("Min / Max"); ImGui::NextColumn();
+    ImGui::Text("RMS"); ImGui::NextColumn();
+    ImGui::Text("Peak |.| [t]"); ImGui::NextColumn();
+    for(int c = 0; c < HODOGRAPH_CHANNEL_COUNT; c++){
+        const RunningStatistics& channel = statistics.Get(
+                static_cast<HodographChannel>(c), static_cast<Axis>(axis));
+        ImGui::Text("%s", channels[c]); ImGui::NextColumn();
+        ImGui::Text("%.4f", channel.mean); ImGui::NextColumn();
+        ImGui::Text("%.4f", sqrt(channel.variance())); ImGui::NextColumn();
+        ImGui::Text("%.3f / %.3f", channel.min, channel.max);
+        ImGui::NextColumn();
+        ImGui::Text("%.4f", channel.rms()); ImGui::NextColumn();
+        ImGui::Text("%.3f [%.2f s]", channel.peak, channel.peak_time);
+        ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+
+    const RunningStatistics& position
+            = statistics.Get(HodographChannel::POSITION, Axis::Z);
+    ImGui::Text("Samples: %llu, Invalid: %llu",
+                position.count, position.invalid);
+}
+
+void ExampleGUI::RenderKinematicsThread(){
+    KinematicsThread& thread = hodograph_simulation_->kinematics_thread();
+    const HodographFrame& frame = hodograph_simulation_->frame();
+    static float rate = (float)thread.rate();
+
+    ImGui::InputFloat("Rate [Hz]", &rate, 100, 1000);
+    if(rate < 1)
+        rate = 1;
+    ImGui::SameLine();
+    if (ImGui::Button("Set")) {
+        thread.SetRate(rate);
+    }
+    ImGui::Text("Simulation Time: %.2f [s]", frame.time);
+    ImGui::Text("Steps: %lld, Dropped: %llu",
+                thread.steps(), thread.dropped_frames());
+}
+
+void ExampleGUI::RenderProfiler(){
+    bool enabled = Profiler::enabled();
+    if(ImGui::Checkbox("Profile Stages", &enabled)){
+        Profiler::enabled(enabled);
+        Profiler::Clear();
+    }
+    if(!enabled)
+        return;
+    bool detailed = Profiler::detailed();
+    if(ImGui::Checkbox("Step Details (slows the kinematics)", &detailed))
+        Profiler::detailed(detailed);
+
+    profile_events_.clear();
+    Profiler::Collect(profile_events_, Profiler::Now() - PROFILE_WINDOW);
+    ComputeStageStatistics(profile_events_, stage_statistics_);
+
+    ImGui::Columns(5, "stages");
+    ImGui::Text("Stage"); ImGui::NextColumn();
+    ImGui::Text("Count/s"); ImGui::NextColumn();
+    ImGui::Text("p50 [us]"); ImGui::NextColumn();
+    ImGui::Text("p99 [us]"); ImGui::NextColumn();
+    ImGui::Text("Max [us]"); ImGui::NextColumn();
+    for(std::size_t i = 0; i < stage_statistics_.size(); i++){
+        const StageStatistics& stage = stage_statistics_[i];
+        ImGui::Text("%s", stage.name); ImGui::NextColumn();
+        ImGui::Text("%zu", stage.count); ImGui::NextColumn();
+        ImGui::Text("%.2f", stage.p50); ImGui::NextColumn();
+        ImGui::Text("%.2f", stage.p99); ImGui::NextColumn();
+        ImGui::Text("%.2f", stage.max); ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+
+    static char path[256] = "hodograph_profile.json";
+    static bool exported = true;
+    ImGui::InputText("Profile File", path, sizeof(path));
+    if(ImGui::Button("Export Chrome Trace")){
+        std::vector<ProfileEvent> events;
+        Profiler::Collect(events);
+        exported = WriteChromeTrace(path, events, Profiler::Threads());
+    }
+    if(!exported){
+        ImGui::SameLine();
+        ImGui::Text("Could not write %s", path);
+    }
 }
 
 void ExampleGUI::RenderProperties(){
@@ -78,6 +237,21 @@ void ExampleGUI::RenderProperties(){
     ImGui::SliderFloat("Error",
                        hodograph_simulation_->error(), 0, 0.1);
 
+    HodographSettings& settings = hodograph_simulation_->settings();
+    RenderMechanism(settings.mechanism);
+    const char* derivative_methods[] = {"Finite Difference", "Analytic"};
+    int derivative_method = static_cast<int>(settings.derivative_method);
+    if(ImGui::Combo("Derivatives", &derivative_method,
+                    derivative_methods, 2)){
+        settings.derivative_method
+                = static_cast<DerivativeMethod>(derivative_method);
+    }
+    if(settings.derivative_method == DerivativeMethod::FINITE_DIFFERENCE)
+        RenderDerivativeFilter(settings.filter);
+    int seed = static_cast<int>(settings.seed);
+    if(ImGui::InputInt("Seed", &seed) && seed >= 0)
+        settings.seed = static_cast<uint64_t>(seed);
+
     static float line_error_length = hodograph_simulation_->line_error_length();
     static float alpha = hodograph_simulation_->alpha();
     line_error_length = hodograph_simulation_->line_error_length();
@@ -86,8 +260,252 @@ void ExampleGUI::RenderProperties(){
     ImGui::InputFloat("Alpha", &alpha);
 }
 
+void ExampleGUI::RenderMechanism(MechanismSettings& mechanism){
+    const char* mechanisms[] = {
+            MechanismName(MechanismType::CRANK_SLIDER),
+            MechanismName(MechanismType::OFFSET_SLIDER_CRANK),
+            MechanismName(MechanismType::FOUR_BAR),
+            MechanismName(MechanismType::TWO_LOOP)};
+    int type = static_cast<int>(mechanism.type);
+    if(ImGui::Combo("Mechanism", &type, mechanisms, 4)){
+        // The crank angle of the two kinematics differs, start over.
+        mechanism.type = static_cast<MechanismType>(type);
+        hodograph_simulation_->ResetKinematics();
+    }
+
+    switch(mechanism.type){
+        case MechanismType::OFFSET_SLIDER_CRANK:
+            ImGui::SliderFloat("Offset", &mechanism.offset, -5, 5);
+            break;
+        case MechanismType::TWO_LOOP:
+            ImGui::SliderFloat("Output Length",
+                               &mechanism.output_length, 0.1, 10);
+            // fall through
+        case MechanismType::FOUR_BAR:
+            ImGui::SliderFloat("Ground", &mechanism.ground, 0.1, 10);
+            ImGui::SliderFloat("Rocker", &mechanism.rocker, 0.1, 10);
+            break;
+        default:
+            return;
+    }
+    const HodographFrame& frame = hodograph_simulation_->frame();
+    const char* status = "OK";
+    if(frame.linkage_status == LinkageStatus::SINGULAR)
+        status = "Singular";
+    else if(frame.linkage_status == LinkageStatus::NOT_CONVERGED)
+        status = "Not Converged";
+    ImGui::Text("Linkage: %s, %d iterations", status,
+                frame.linkage_iterations);
+}
+
+void ExampleGUI::RenderDerivativeFilter(FilterSettings& filter){
+    const char* filter_types[] = {"None", "Savitzky-Golay",
+                                  "Moving Average", "Exponential"};
+    int filter_type = static_cast<int>(filter.type);
+    if(ImGui::Combo("Derivative Filter", &filter_type, filter_types, 4))
+        filter.type = static_cast<FilterType>(filter_type);
+
+    switch(filter.type){
+        case FilterType::SAVITZKY_GOLAY:
+            ImGui::SliderInt("Half Window", &filter.half_window, 1,
+                             FilterSettings::MAX_HALF_WINDOW);
+            ImGui::SliderInt("Order", &filter.order, 2, std::max(
+                    2, FilterSettings::MaxOrder(filter.half_window)));
+            break;
+        case FilterType::MOVING_AVERAGE:
+            ImGui::SliderInt("Half Window", &filter.half_window, 1,
+                             FilterSettings::MAX_HALF_WINDOW);
+            break;
+        case FilterType::EXPONENTIAL:
+            ImGui::SliderFloat("Smoothing", &filter.smoothing, 0.01f, 1.0f);
+            break;
+        default:
+            return;
+    }
+    double rate = hodograph_simulation_->kinematics_thread().rate();
+    float delay = FilterGroupDelay(filter);
+    ImGui::Text("Delay: %.1f steps, %.2f [ms]", delay,
+                1000.0 * delay / rate);
+}
+
+void ExampleGUI::RenderSpectrum(){
+    bool enabled = hodograph_simulation_->spectrum_enabled();
+    if(ImGui::Checkbox("Enabled", &enabled))
+        hodograph_simulation_->spectrum_enabled(enabled);
+
+    SpectrumSettings& settings = hodograph_simulation_->spectrum_settings();
+    ImGui::SliderInt("Harmonics", &settings.harmonics, 1, 16);
+    int fft_size = 0;
+    while(fft_size < FFT_SIZE_COUNT - 1
+          && FFT_SIZES[fft_size] < settings.fft_size)
+        fft_size++;
+    if(ImGui::Combo("FFT Size", &fft_size, FFT_SIZE_NAMES, FFT_SIZE_COUNT))
+        settings.fft_size = FFT_SIZES[fft_size];
+    ImGui::SliderFloat("FFT Period [s]", &settings.fft_period, 0.1f, 5.0f);
+    if(!enabled)
+        return;
+
+    const SpectrumAnalyzer& spectrum = hodograph_simulation_->spectrum();
+    const SlidingDft& position = spectrum.dft(HodographChannel::POSITION);
+    ImGui::Text("Revolution: %zu samples%s", position.window(),
+                position.full() ? "" : " (filling)");
+    ImGui::Text("FFT Resolution: %.4f [Hz]", spectrum.fft_resolution());
+
+    RenderSpectrumChannel("Position", HodographChannel::POSITION);
+    RenderSpectrumChannel("Velocity", HodographChannel::VELOCITY);
+    RenderSpectrumChannel("Acceleration", HodographChannel::ACCELERATION);
+}
+
+void ExampleGUI::RenderSpectrumChannel(const char* label,
+                                       HodographChannel channel){
+    const SpectrumAnalyzer& spectrum = hodograph_simulation_->spectrum();
+    const SlidingDft& dft = spectrum.dft(channel);
+    const std::vector<float>& fft = spectrum.fft(channel);
+
+    ImGui::PushID(label);
+    ImGui::Text("%s, mean: %.4f, 1w: %.4f, 2w: %.4f", label,
+                dft.Amplitude(0), dft.Amplitude(1),
+                dft.bins() > 2 ? dft.Amplitude(2) : 0.0f);
+    ImGui::PlotHistogram("Harmonics", PlotHarmonic, (void*)&dft,
+                         (int)dft.bins() - 1, 0, "1w .. kw",
+                         0, FLT_MAX, ImVec2(0, 60));
+    if(fft.size() > 1){
+        // Bin 0 is the mean, it would flatten the rest of the plot.
+        ImGui::PlotLines("FFT", fft.data() + 1, (int)fft.size() - 1, 0,
+                         "Amplitude", 0, FLT_MAX, ImVec2(0, 60));
+    }
+    ImGui::PopID();
+}
+
+void ExampleGUI::RenderEnsemble(){
+    HodographEnsemble& ensemble = hodograph_simulation_->ensemble();
+    static int size = (int)ensemble.size();
+
+    bool enabled = hodograph_simulation_->ensemble_enabled();
+    if(ImGui::Checkbox("Enabled", &enabled))
+        hodograph_simulation_->ensemble_enabled(enabled);
+
+    ImGui::InputInt("Members", &size, 256, 4096);
+    if(size < 1)
+        size = 1;
+    ImGui::SameLine();
+    if (ImGui::Button("Apply")) {
+        hodograph_simulation_->ResetEnsemble(size);
+    }
+
+    const EnsembleStep& statistics = ensemble.statistics();
+    const RingBuffer<EnsembleStep>& history
+            = hodograph_simulation_->ensemble_history();
+    const EnsembleStep* steps = history.data();
+    RenderEnsembleStatistics("Position", statistics.position,
+                             &steps->position.mean);
+    RenderEnsembleStatistics("Velocity", statistics.velocity,
+                             &steps->velocity.mean);
+    RenderEnsembleStatistics("Acceleration", statistics.acceleration,
+                             &steps->acceleration.mean);
+}
+
+void ExampleGUI::RenderEnsembleStatistics(const char* label,
+                                          const SummaryStatistics& statistics,
+                                          const float* history_mean){
+    const RingBuffer<EnsembleStep>& history
+            = hodograph_simulation_->ensemble_history();
+
+    ImGui::Text("%s: mean %.4f, variance %.6f", label,
+                statistics.mean, statistics.variance);
+    ImGui::Text("    p05 %.4f, p50 %.4f, p95 %.4f, invalid %d",
+                statistics.p05, statistics.p50, statistics.p95,
+                (int)statistics.invalid);
+    ImGui::PlotLines(label,
+                     history_mean,
+                     history.size(),
+                     history.offset(),
+                     "mean",
+                     FLT_MAX, FLT_MAX, ImVec2(0,80),
+                     sizeof(EnsembleStep));
+}
+
+void ExampleGUI::RenderTrace(){
+    static char path[256] = "hodograph.trace";
+    ImGui::InputText("File", path, sizeof(path));
+
+    TraceWriter& writer = hodograph_simulation_->trace_writer();
+    if(!writer.is_open()){
+        if(ImGui::Button("Record"))
+            hodograph_simulation_->StartRecording(path);
+    }else{
+        if(ImGui::Button("Stop Recording"))
+            hodograph_simulation_->StopRecording();
+    }
+    ImGui::SameLine();
+
+    TraceReader& reader = hodograph_simulation_->trace_reader();
+    if(!hodograph_simulation_->is_replaying()){
+        if(ImGui::Button("Replay"))
+            hodograph_simulation_->StartReplay(path);
+    }else{
+        if(ImGui::Button("Stop Replay"))
+            hodograph_simulation_->StopReplay();
+    }
+
+    ImGui::Text("Written: %llu, Dropped: %llu",
+                writer.written(), writer.dropped());
+    std::string error = writer.error();
+    if(!error.empty())
+        ImGui::Text("%s", error.c_str());
+    if(!reader.error().empty())
+        ImGui::Text("%s", reader.error().c_str());
+
+    static char telemetry_name[64] = "/hodograph";
+    ImGui::InputText("Shared Memory", telemetry_name,
+                     sizeof(telemetry_name));
+    TelemetryPublisher& telemetry = hodograph_simulation_->telemetry();
+    if(!telemetry.is_open()){
+        if(ImGui::Button("Publish"))
+            hodograph_simulation_->StartTelemetry(telemetry_name);
+    }else{
+        if(ImGui::Button("Stop Publishing"))
+            hodograph_simulation_->StopTelemetry();
+        ImGui::SameLine();
+        ImGui::Text("Published: %llu", telemetry.published());
+    }
+    if(!telemetry.error().empty())
+        ImGui::Text("%s", telemetry.error().c_str());
+
+    if(hodograph_simulation_->is_replaying() && reader.size() > 0){
+        int cursor = (int)*hodograph_simulation_->replay_cursor();
+        if(ImGui::SliderInt("Cursor", &cursor, 0, (int)reader.size() - 1))
+            *hodograph_simulation_->replay_cursor() = cursor;
+        const TraceHeader& header = reader.header();
+        ImGui::Text("Records: %d, Seed: %llu", (int)reader.size(),
+                    (unsigned long long)header.seed);
+        ImGui::Text("w = %.3f, r = %.3f, L = %.3f, error = %.3f",
+                    header.parameters.angular_velocity,
+                    header.parameters.radius,
+                    header.parameters.line_length,
+                    header.parameters.error);
+    }
+}
+
 void ExampleGUI::RenderGraphs(){
+    ProfileScope scope("RenderGraphs");
     RenderPositionGraphs();
+    if(ImGui::TreeNode("Full History")){
+        RenderFullHistory();
+        ImGui::TreePop();
+    }
+    if(ImGui::TreeNode("Diagnostics")){
+        RenderDerivativeDiagnostics();
+        ImGui::TreePop();
+    }
+    if(ImGui::TreeNode("Sensitivities")){
+        RenderSensitivities();
+        ImGui::TreePop();
+    }
+    if(ImGui::TreeNode("Cycles")){
+        RenderCycles();
+        ImGui::TreePop();
+    }
 
     ImGui::Begin("Phase");
     RenderPhaseonGraphs();
@@ -95,63 +513,315 @@ void ExampleGUI::RenderGraphs(){
 }
 
 void ExampleGUI::RenderPositionGraphs(){
-    std::vector<float>& positions
-            = hodograph_simulation_->hodograph_cache().positions_z;
-    std::vector<float>& velocities
-            = hodograph_simulation_->hodograph_cache().velocities_z;
-    std::vector<float>& accelerations
-            = hodograph_simulation_->hodograph_cache().accelerations_z;
+    if(hodograph_simulation_->is_replaying()){
+        RenderReplayGraphs();
+        return;
+    }
+
+    HodographCache& cache = hodograph_simulation_->hodograph_cache();
     if (ImGui::Button("Reset")) {
         hodograph_simulation_->ResetCache();
     }
+    RenderHistoryCapacity();
+
+    static int window = (int)cache.capacity();
+    ImGui::SliderInt("Window", &window, 16, (int)cache.capacity());
+
+    std::size_t end = cache.size();
+    std::size_t begin = end > (std::size_t)window ? end - window : 0;
+    RenderHistoryPlot("Position", HodographChannel::POSITION, "x",
+                      begin, end);
+    RenderHistoryPlot("Velocity", HodographChannel::VELOCITY, "v",
+                      begin, end);
+    RenderHistoryPlot("Acceleration", HodographChannel::ACCELERATION, "a",
+                      begin, end);
+}
+
+void ExampleGUI::RenderHistoryPlot(const char* label,
+                                   HodographChannel channel,
+                                   const char* overlay,
+                                   std::size_t begin, std::size_t end){
+    HodographCache& cache = hodograph_simulation_->hodograph_cache();
+
+    // One min/max pair per pixel, drawn as a zig-zag that fills the envelope.
+    int width = (int)ImGui::CalcItemWidth() / 2;
+    if(width < 1)
+        width = 1;
+    if(plot_columns_.size() < (std::size_t)width)
+        plot_columns_.resize(width);
+    if(end - begin < (std::size_t)width)
+        width = (int)(end - begin);
+
+    MinMax bounds = cache.Resample(channel, Axis::Z, begin, end,
+                                   plot_columns_.data(), width);
+    ImGui::PlotLines(label,
+                     PlotMinMaxColumn,
+                     plot_columns_.data(),
+                     width * 2,
+                     0,
+                     overlay,
+                     bounds.min, bounds.max, ImVec2(0,80));
+}
+
+void ExampleGUI::RenderFullHistory(){
+    bool enabled = hodograph_simulation_->full_history_enabled();
+    if(ImGui::Checkbox("Enabled", &enabled))
+        hodograph_simulation_->full_history_enabled(enabled);
+
+    const CompressedHistory& history = hodograph_simulation_->full_history();
+    double memory = history.memory_bytes();
+    double raw = history.raw_bytes();
+    ImGui::Text("Samples: %zu, Pending Chunks: %zu", history.size(),
+                history.pending_chunks());
+    ImGui::Text("Memory: %.2f MB, Uncompressed: %.2f MB, Ratio: %.1f",
+                memory / (1024 * 1024), raw / (1024 * 1024),
+                memory > 0 ? raw / memory : 0.0);
+    if(history.size() == 0)
+        return;
+
+    RenderFullHistoryPlot("Position", HodographChannel::POSITION, "x");
+    RenderFullHistoryPlot("Velocity", HodographChannel::VELOCITY, "v");
+    RenderFullHistoryPlot("Acceleration", HodographChannel::ACCELERATION,
+                          "a");
+}
+
+void ExampleGUI::RenderFullHistoryPlot(const char* label,
+                                       HodographChannel channel,
+                                       const char* overlay){
+    const CompressedHistory& history = hodograph_simulation_->full_history();
+
+    int width = (int)ImGui::CalcItemWidth() / 2;
+    if(width < 1)
+        width = 1;
+    if(plot_columns_.size() < (std::size_t)width)
+        plot_columns_.resize(width);
+    if(history.size() < (std::size_t)width)
+        width = (int)history.size();
+
+    MinMax bounds = history.Resample(channel, Axis::Z, 0, history.size(),
+                                     plot_columns_.data(), width);
+    ImGui::PushID("FullHistory");
+    ImGui::PlotLines(label,
+                     PlotMinMaxColumn,
+                     plot_columns_.data(),
+                     width * 2,
+                     0,
+                     overlay,
+                     bounds.min, bounds.max, ImVec2(0,80));
+    ImGui::PopID();
+}
+
+void ExampleGUI::RenderReplayGraphs(){
+    TraceReader& reader = hodograph_simulation_->trace_reader();
+    const TraceRecord* records = reader.records();
+    if(reader.size() == 0)
+        return;
+
+    // Plots read the mapped records in place through the stride.
+    static int window = 4096;
+    ImGui::SliderInt("Window", &window, 16, 65536);
+    std::size_t end = std::min(*hodograph_simulation_->replay_cursor() + 1,
+                               reader.size());
+    std::size_t begin = end > (std::size_t)window ? end - window : 0;
+    int count = (int)(end - begin);
 
     ImGui::PlotLines("Position",
-                     positions.data(),
-                     positions.size(),
+                     &records[begin].position.z,
+                     count,
                      0,
                      "x",
-                     FLT_MAX, FLT_MAX, ImVec2(0,80));
-
+                     FLT_MAX, FLT_MAX, ImVec2(0,80),
+                     sizeof(TraceRecord));
     ImGui::PlotLines("Velocity",
-                     velocities.data(),
-                     velocities.size(),
+                     &records[begin].velocity.z,
+                     count,
                      0,
                      "v",
-                     FLT_MAX, FLT_MAX, ImVec2(0,80));
-
+                     FLT_MAX, FLT_MAX, ImVec2(0,80),
+                     sizeof(TraceRecord));
     ImGui::PlotLines("Acceleration",
-                     accelerations.data(),
-                     accelerations.size(),
+                     &records[begin].acceleration.z,
+                     count,
                      0,
                      "a",
-                     FLT_MAX, FLT_MAX, ImVec2(0,80));
+                     FLT_MAX, FLT_MAX, ImVec2(0,80),
+                     sizeof(TraceRecord));
+}
+
+void ExampleGUI::RenderHistoryCapacity(){
+    HodographCache& cache = hodograph_simulation_->hodograph_cache();
+    static int capacity = (int)cache.capacity();
+
+    ImGui::InputInt("History", &capacity, 1024, 16384);
+    if(capacity < 1)
+        capacity = 1;
+    ImGui::SameLine();
+    if (ImGui::Button("Apply")) {
+        cache.SetCapacity(capacity);
+    }
+    ImGui::Text("Samples: %d / %d (%.1f KB)",
+                (int)cache.size(), (int)cache.capacity(),
+                cache.memory_bytes() / 1024.0f);
+}
+
+void ExampleGUI::RenderDerivativeDiagnostics(){
+    HodographSettings& settings = hodograph_simulation_->settings();
+    ImGui::Checkbox("Finite Difference - Analytic",
+                    &settings.diagnostics_enabled);
+
+    const RingBuffer<HodographSample>& history
+            = hodograph_simulation_->derivative_difference_history();
+    const HodographSample& difference
+            = hodograph_simulation_->frame().derivative_difference;
+    ImGui::Text("Velocity: %.6f, Acceleration: %.6f",
+                difference.velocity.z, difference.acceleration.z);
+
+    ImGui::PlotLines("Velocity Difference",
+                     &history.data()->velocity.z,
+                     history.size(),
+                     history.offset(),
+                     "dv",
+                     FLT_MAX, FLT_MAX, ImVec2(0,80),
+                     sizeof(HodographSample));
+    ImGui::PlotLines("Acceleration Difference",
+                     &history.data()->acceleration.z,
+                     history.size(),
+                     history.offset(),
+                     "da",
+                     FLT_MAX, FLT_MAX, ImVec2(0,80),
+                     sizeof(HodographSample));
+}
+
+void ExampleGUI::RenderSensitivities(){
+    HodographSettings& settings = hodograph_simulation_->settings();
+    ImGui::Checkbox("Enabled", &settings.sensitivity_enabled);
+
+    static int parameter = static_cast<int>(SensitivityParameter::RADIUS);
+    const char* parameters[] = {"Radius", "Line Length", "Angular Velocity"};
+    ImGui::Combo("Parameter", &parameter, parameters,
+                 SENSITIVITY_PARAMETER_COUNT);
+
+    const RingBuffer<HodographSensitivity>& history
+            = hodograph_simulation_->sensitivity_history();
+    const SliderSensitivity& current
+            = hodograph_simulation_->frame().sensitivity.parameters[parameter];
+    ImGui::Text("dx: %.4f, dv: %.4f, da: %.4f",
+                current.position, current.velocity, current.acceleration);
+
+    const SliderSensitivity* data = &history.data()->parameters[parameter];
+    ImGui::PlotLines("Position Sensitivity",
+                     &data->position,
+                     history.size(),
+                     history.offset(),
+                     "dx",
+                     FLT_MAX, FLT_MAX, ImVec2(0,80),
+                     sizeof(HodographSensitivity));
+    ImGui::PlotLines("Velocity Sensitivity",
+                     &data->velocity,
+                     history.size(),
+                     history.offset(),
+                     "dv",
+                     FLT_MAX, FLT_MAX, ImVec2(0,80),
+                     sizeof(HodographSensitivity));
+    ImGui::PlotLines("Acceleration Sensitivity",
+                     &data->acceleration,
+                     history.size(),
+                     history.offset(),
+                     "da",
+                     FLT_MAX, FLT_MAX, ImVec2(0,80),
+                     sizeof(HodographSensitivity));
+}
+
+void ExampleGUI::RenderCycles(){
+    const RingBuffer<CycleRecord>& history
+            = hodograph_simulation_->cycle_history();
+    if(history.empty()){
+        ImGui::Text("No finished revolution");
+        return;
+    }
+
+    const CycleRecord& last = history.back();
+    ImGui::Text("Revolution %u, period %.4f [s], %u samples",
+                last.index, last.period, last.samples);
+    ImGui::Text("Stroke: %.4f, top %.4f at %.3f [s], bottom %.4f at %.3f [s]",
+                last.stroke(), last.top_position, last.top_time,
+                last.bottom_position, last.bottom_time);
+    ImGui::Text("Peak velocity: %.4f at %.3f [rad]",
+                last.peak_velocity, last.peak_velocity_alpha);
+    ImGui::Text("Peak acceleration: %.4f at %.3f [rad]",
+                last.peak_acceleration, last.peak_acceleration_alpha);
+    ImGui::Text("Error RMS: %.6f", last.error_rms);
+
+    // The stroke is derived, its ends are plotted.
+    ImGui::PlotLines("Top Position",
+                     &history.data()->top_position,
+                     history.size(),
+                     history.offset(),
+                     "top",
+                     FLT_MAX, FLT_MAX, ImVec2(0,80),
+                     sizeof(CycleRecord));
+    ImGui::PlotLines("Bottom Position",
+                     &history.data()->bottom_position,
+                     history.size(),
+                     history.offset(),
+                     "bottom",
+                     FLT_MAX, FLT_MAX, ImVec2(0,80),
+                     sizeof(CycleRecord));
+    ImGui::PlotLines("Peak Velocity",
+                     &history.data()->peak_velocity,
+                     history.size(),
+                     history.offset(),
+                     "v",
+                     FLT_MAX, FLT_MAX, ImVec2(0,80),
+                     sizeof(CycleRecord));
+    ImGui::PlotLines("Error RMS",
+                     &history.data()->error_rms,
+                     history.size(),
+                     history.offset(),
+                     "rms",
+                     FLT_MAX, FLT_MAX, ImVec2(0,80),
+                     sizeof(CycleRecord));
 }
 
 void ExampleGUI::RenderPhaseonGraphs(){
-    std::vector<float>& positions
-            = hodograph_simulation_->hodograph_cache().positions_z;
-    std::vector<float>& velocities
-            = hodograph_simulation_->hodograph_cache().velocities_z;
-    const int MAX = 10000;
+    ProfileScope scope("RenderPhaseonGraphs");
+    const PhaseDensity& density = hodograph_simulation_->phase_density();
+    if(density.size() == 0)
+        return;
 
     static ImVec4 col = ImVec4(1.0f,1.0f,0.4f,1.0f);
-    const ImU32 col32 = ImColor(col);
+    MinMax x_range = density.x_range();
+    MinMax v_range = density.v_range();
+    ImGui::Text("x: [%.3f, %.3f], v: [%.3f, %.3f], samples: %zu",
+                x_range.min, x_range.max, v_range.min, v_range.max,
+                density.size());
+    int fast_forward = hodograph_simulation_->kinematics_thread()
+            .fast_forward();
+    if(fast_forward > 1)
+        ImGui::Text("Fast forward: every %d-th step only", fast_forward);
 
     ImDrawList* draw_list = ImGui::GetWindowDrawList();
     const ImVec2 p = ImGui::GetCursorScreenPos();
+    ImVec2 size = ImGui::GetContentRegionAvail();
+    size.x = std::max(size.x, 64.0f);
+    size.y = std::max(size.y, 64.0f);
+    ImGui::Dummy(size);
 
-    float scale = 80.0f;
-    float offset = 200.0f;
-    float offset_pos = 0.0f;
-    float offset_vel = 0.0f;
-    for(int i = 1; i < positions.size(); i++){
-        float x = p.x + offset + (positions[i-1] + offset_pos) * scale;
-        float y = p.y + offset + (velocities[i-1] + offset_vel)* scale;
-
-        float x1 = p.x + offset + (positions[i] + offset_pos) * scale;
-        float y1 = p.y + offset + (velocities[i] + offset_vel)* scale;
-        draw_list->AddLine(ImVec2(x, y),
-                           ImVec2(x1, y1), col32, 0.5f);
-        if (i > MAX) break;
+    // One rectangle per run of equal intensity, not per cell, at most
+    // DEFAULT_MAX_RUNS per frame. Intensity is logarithmic so rarely
+    // visited cells stay visible.
+    const int levels = PhaseDensity::DEFAULT_LEVELS;
+    density.Runs(levels, PhaseDensity::DEFAULT_MAX_RUNS, density_runs_);
+    float cell_width = size.x / density.width();
+    float cell_height = size.y / density.height();
+    for(const DensityRun& run : density_runs_){
+        // Row 0 holds the lowest velocities, drawn at the bottom.
+        float y = p.y + size.y - (run.row + run.rows) * cell_height;
+        float alpha = (float)run.level / levels;
+        draw_list->AddRectFilled(
+                ImVec2(p.x + run.begin * cell_width, y),
+                ImVec2(p.x + run.end * cell_width,
+                       y + run.rows * cell_height),
+                ImColor(col.x, col.y, col.z, 0.15f + 0.85f * alpha));
     }
 }
\ No newline at end of file
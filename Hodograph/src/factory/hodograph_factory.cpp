@@ -2,55 +2,43 @@
 
 #include <object/render_object.h>
 #include <object/game_object.h>
-#include <graphics/factory/model_factory.h>
-#include <graphics/factory/program_factory.h>
-#include <graphics/factory/texture_factory.h>
 
-HodographFactory::HodographFactory(){}
-HodographFactory::~HodographFactory(){}
+namespace {
 
-std::shared_ptr<ifx::GameObject> HodographFactory::CreateCircle(){
-    auto material = std::shared_ptr<ifx::Material>(new ifx::Material());
-    glm::vec3 color(255, 0 ,0);
-    material->diffuse = ifx::TextureFactory().CreateSolidColorTexture(
-            color, ifx::TextureTypes::DIFFUSE);
-    material->specular = ifx::TextureFactory().CreateSolidColorTexture(
-            color, ifx::TextureTypes::SPECULAR);
+const glm::vec3 CIRCLE_COLOR(255, 0, 0);
+const glm::vec3 BOX_COLOR(0, 255, 0);
 
-    auto model = ifx::ModelFactory::LoadCircle(1);
-    model->getMesh(0)->material(material);
-    auto program = ifx::ProgramFactory().LoadMainProgram();
+}
 
-    auto renderObject
-            = std::shared_ptr<ifx::RenderObject>(
-                    new ifx::RenderObject(ObjectID(0),model));
-    renderObject->addProgram(program);
+HodographFactory::HodographFactory(
+        std::shared_ptr<HodographResources> resources) :
+        resources_(resources){}
+HodographFactory::~HodographFactory(){}
 
-    auto game_object = std::shared_ptr<ifx::GameObject>(new ifx::GameObject());
-    game_object->Add(renderObject);
+void HodographFactory::WarmUp(){
+    resources_->program();
+    resources_->model(ResourceMesh::CIRCLE, CIRCLE_COLOR);
+    resources_->model(ResourceMesh::QUAD, BOX_COLOR);
+}
 
-    return game_object;
+std::shared_ptr<ifx::GameObject> HodographFactory::CreateCircle(){
+    return Create(ResourceMesh::CIRCLE, CIRCLE_COLOR);
 }
 
 std::shared_ptr<ifx::GameObject> HodographFactory::CreateBox(){
-    auto material = std::shared_ptr<ifx::Material>(new ifx::Material());
-    glm::vec3 color(0, 255 ,0);
-    material->diffuse = ifx::TextureFactory().CreateSolidColorTexture(
-            color, ifx::TextureTypes::DIFFUSE);
-    material->specular = ifx::TextureFactory().CreateSolidColorTexture(
-            color, ifx::TextureTypes::SPECULAR);
-
-    auto model = ifx::ModelFactory::CreateQuad(1,1);
-    model->getMesh(0)->material(material);
-    auto program = ifx::ProgramFactory().LoadMainProgram();
+    return Create(ResourceMesh::QUAD, BOX_COLOR);
+}
 
+std::shared_ptr<ifx::GameObject> HodographFactory::Create(
+        ResourceMesh mesh, const glm::vec3& color){
     auto renderObject
             = std::shared_ptr<ifx::RenderObject>(
-                    new ifx::RenderObject(ObjectID(0),model));
-    renderObject->addProgram(program);
+                    new ifx::RenderObject(ObjectID(0),
+                                          resources_->model(mesh, color)));
+    renderObject->addProgram(resources_->program());
 
     auto game_object = std::shared_ptr<ifx::GameObject>(new ifx::GameObject());
     game_object->Add(renderObject);
 
     return game_object;
-}
\ No newline at end of file
+}
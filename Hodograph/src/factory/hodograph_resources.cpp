@@ -0,0 +1,58 @@
+#include "factory/hodograph_resources.h"
+
+#include <object/render_object.h>
+#include <graphics/factory/model_factory.h>
+#include <graphics/factory/program_factory.h>
+#include <graphics/factory/texture_factory.h>
+
+HodographResources::HodographResources(){}
+HodographResources::~HodographResources(){}
+
+std::shared_ptr<HodographResources> HodographResources::Shared(){
+    static std::shared_ptr<HodographResources> resources(
+            new HodographResources());
+    return resources;
+}
+
+std::shared_ptr<ifx::Program> HodographResources::program(){
+    if(!program_)
+        program_ = ifx::ProgramFactory().LoadMainProgram();
+    return program_;
+}
+
+std::shared_ptr<ifx::Material> HodographResources::material(
+        const glm::vec3& color){
+    ColorKey key(color.x, color.y, color.z);
+    auto found = materials_.find(key);
+    if(found != materials_.end())
+        return found->second;
+
+    auto material = std::shared_ptr<ifx::Material>(new ifx::Material());
+    material->diffuse = ifx::TextureFactory().CreateSolidColorTexture(
+            color, ifx::TextureTypes::DIFFUSE);
+    material->specular = ifx::TextureFactory().CreateSolidColorTexture(
+            color, ifx::TextureTypes::SPECULAR);
+    materials_[key] = material;
+    return material;
+}
+
+std::shared_ptr<ifx::Model> HodographResources::model(
+        ResourceMesh mesh, const glm::vec3& color){
+    ModelKey key(static_cast<int>(mesh), color.x, color.y, color.z);
+    auto found = models_.find(key);
+    if(found != models_.end())
+        return found->second;
+
+    std::shared_ptr<ifx::Model> model;
+    switch(mesh){
+        case ResourceMesh::CIRCLE:
+            model = ifx::ModelFactory::LoadCircle(1);
+            break;
+        case ResourceMesh::QUAD:
+            model = ifx::ModelFactory::CreateQuad(1,1);
+            break;
+    }
+    model->getMesh(0)->material(material(color));
+    models_[key] = model;
+    return model;
+}
@@ -3,46 +3,147 @@
 #include <object/game_object.h>
 #include <game/scene_container.h>
 #include <graphics/factory/render_object_factory.h>
+#include <memory/allocation_counter.h>
+#include <profiling/profiler.h>
+
+#include <cmath>
+
+namespace {
+
+glm::vec3 ToGLM(const Vec3& v){
+    return glm::vec3(v.x, v.y, v.z);
+}
+
+}
 
 HodographSimulation::HodographSimulation(
         std::shared_ptr<ifx::GameObject> circle,
         std::shared_ptr<ifx::GameObject> box,
         std::shared_ptr<ifx::SceneContainer> scene) :
-        angular_velocity_(1),
-        radius_(1),
-        line_length_(radius_*3),
-        line_error_length_(line_length_),
-        error_(0),
-        alpha_(0),
+        full_history_enabled_(false),
+        replay_cursor_(0),
+        last_replay_cursor_(0),
+        replay_time_(0),
+        ensemble_history_(1024),
+        ensemble_enabled_(false),
+        derivative_difference_history_(1024),
+        sensitivity_history_(1024),
+        cycle_history_(4096),
+        spectrum_enabled_(false),
+        fft_elapsed_(0),
         scene_(scene),
-        is_first_iteration_(true){
+        update_allocations_(0){
     game_objects_.circle = circle;
     game_objects_.box = box;
 
+    frame_ = HodographFrame();
+    frame_.step = -1;
+
     InitGameObjects();
+
+    Profiler::SetThreadName("Main");
+    kinematics_thread_.PushSettings(settings_);
+    sent_settings_ = settings_;
+    kinematics_thread_.Start();
 }
 
 HodographSimulation::~HodographSimulation(){}
 
 void HodographSimulation::Update(){
-    if(!UpdateTime())
+    bool running = UpdateTime();
+    kinematics_thread_.SetRunning(running && !is_replaying());
+    if(!running)
             return;
 
-    UpdateLine();
-    UpdateGameObjects();
-    UpdateCache();
+    AllocationCounter allocations;
+    ProfileScope scope("Update");
 
-    is_first_iteration_ = false;
+    if(is_replaying()){
+        UpdateReplay();
+    }else{
+        UpdateSettings();
+        UpdateFrames();
+    }
+    if(frame_.step >= 0)
+        UpdateGameObjects();
+    if(ensemble_enabled_)
+        UpdateEnsemble();
+    if(spectrum_enabled_)
+        UpdateSpectrum();
+
+    update_allocations_ = allocations.count();
 }
 
 void HodographSimulation::ResetCache(){
-    hodograph_cache_.positions.clear();
-    hodograph_cache_.velocities.clear();
-    hodograph_cache_.accelerations.clear();
+    hodograph_cache_.Clear();
+    kinematics_thread_.ResetStatistics();
+    statistics_.Clear();
+    phase_density_.Clear();
+    full_history_.Clear();
+    derivative_difference_history_.Clear();
+    sensitivity_history_.Clear();
+    cycle_history_.Clear();
+    spectrum_.Clear();
+}
+
+void HodographSimulation::ResetKinematics(){
+    kinematics_thread_.Reset();
+    ResetCache();
+}
+
+void HodographSimulation::ensemble_enabled(bool value){
+    if(value && !ensemble_enabled_)
+        ResetEnsemble(ensemble_.size());
+    ensemble_enabled_ = value;
+}
+
+void HodographSimulation::full_history_enabled(bool value){
+    if(value && !full_history_enabled_)
+        full_history_.Clear();
+    full_history_enabled_ = value;
+}
+
+void HodographSimulation::spectrum_enabled(bool value){
+    if(value && !spectrum_enabled_)
+        spectrum_.Clear();
+    spectrum_enabled_ = value;
+}
+
+void HodographSimulation::ResetEnsemble(std::size_t size){
+    ensemble_.Reset(size);
+    ensemble_history_.Clear();
+}
+
+bool HodographSimulation::StartRecording(const std::string& path){
+    TraceHeader header = CreateTraceHeader(settings_.parameters,
+                                           settings_.seed);
+    return trace_writer_.Open(path, header);
+}
+
+void HodographSimulation::StopRecording(){
+    trace_writer_.Close();
+}
 
-    hodograph_cache_.positions_z.clear();
-    hodograph_cache_.velocities_z.clear();
-    hodograph_cache_.accelerations_z.clear();
+bool HodographSimulation::StartTelemetry(const std::string& name){
+    return telemetry_.Open(name);
+}
+
+void HodographSimulation::StopTelemetry(){
+    telemetry_.Close();
+}
+
+bool HodographSimulation::StartReplay(const std::string& path){
+    if(!trace_reader_.Open(path))
+        return false;
+    replay_cursor_ = 0;
+    last_replay_cursor_ = 0;
+    replay_time_ = trace_reader_.size() > 0
+                   ? trace_reader_.records()[0].time : 0;
+    return true;
+}
+
+void HodographSimulation::StopReplay(){
+    trace_reader_.Close();
 }
 
 void HodographSimulation::InitGameObjects(){
@@ -51,21 +152,34 @@ void HodographSimulation::InitGameObjects(){
     game_objects_.box->rotateTo(glm::vec3(0, 90, 0));
     game_objects_.box->scale(scale_factor);
 
-    game_objects_.circle->moveTo(glm::vec3(-(radius_ + 0.1f), 0, 0));
+    game_objects_.circle->moveTo(
+            glm::vec3(-(settings_.parameters.radius + 0.1f), 0, 0));
+
+    InitLineGameObject();
+}
+
+void HodographSimulation::InitLineGameObject(){
+    auto render_object = ifx::RenderObjectFactory().CreateLine(
+            glm::vec3(0, 0, 0), glm::vec3(0, 0, 1));
+    game_objects_.line = std::shared_ptr<ifx::GameObject>(new ifx::GameObject());
+    game_objects_.line->Add(render_object);
+    scene_->Add(game_objects_.line);
 }
 
 void HodographSimulation::UpdateGameObjects(){
+    ProfileScope scope("UpdateGameObjects");
     UpdateCircleGameObject();
     UpdateBoxGameObject();
     UpdateLineGameObject();
 }
 
 void HodographSimulation::UpdateCircleGameObject(){
-    game_objects_.circle->scale(glm::vec3(1, radius_, radius_));
+    float radius = settings_.parameters.radius;
+    game_objects_.circle->scale(glm::vec3(1, radius, radius));
 }
 
 void HodographSimulation::UpdateBoxGameObject(){
-    game_objects_.box->moveTo(line_.position1);
+    game_objects_.box->moveTo(ToGLM(frame_.position1));
     const float a = 1;
     const float scale_factor = 0.2f;
 
@@ -73,87 +187,113 @@ void HodographSimulation::UpdateBoxGameObject(){
 }
 
 void HodographSimulation::UpdateLineGameObject(){
-    if(line_.game_object)
-        scene_->Remove(line_.game_object);
-    auto render_object = ifx::RenderObjectFactory().CreateLine(line_.position0,
-                                                               line_.position1);
-    line_.game_object = std::shared_ptr<ifx::GameObject>(new ifx::GameObject());
-    line_.game_object->Add(render_object);
-    scene_->Add(line_.game_object);
-}
-
-void HodographSimulation::UpdateLine(){
-    UpdateErrorLine();
-    UpdateLinePosition();
+    const Vec3& position0 = frame_.position0;
+    Vec3 direction = frame_.position1 - position0;
+    float length = sqrt(direction.y * direction.y
+                        + direction.z * direction.z);
+    float angle = atan2(-direction.y, direction.z) * 180.0f / M_PI;
+
+    game_objects_.line->moveTo(ToGLM(position0));
+    game_objects_.line->rotateTo(glm::vec3(angle, 0, 0));
+    game_objects_.line->scale(glm::vec3(1, 1, length));
 }
 
-void HodographSimulation::UpdateErrorLine(){
-    std::normal_distribution<float> distribution(0, error_);
-    float error_t = distribution(generator_);
-
-    line_error_length_ = line_length_ + error_t;
+void HodographSimulation::UpdateSettings(){
+    if(settings_ == sent_settings_)
+        return;
+    if(kinematics_thread_.PushSettings(settings_))
+        sent_settings_ = settings_;
 }
 
-void HodographSimulation::UpdateLinePosition(){
-    UpdateLinePosition0();
-    UpdateLinePosition1();
-
-    UpdateAlpha();
-}
-
-void HodographSimulation::UpdateLinePosition0(){
-    const float x = -0.01;
-    float z0 = radius_ * sin(alpha_);
-    float y0 = radius_ * cos(alpha_);
-    line_.position0 = glm::vec3(x,y0,z0);
-}
-
-void HodographSimulation::UpdateLinePosition1(){
-    const float x = -0.01;
-
-    float a_sqr = line_error_length_* line_error_length_;
-    float b_sqr = line_.position0.y * line_.position0.y;
-    float lx1 = sqrt(a_sqr - b_sqr);
-    float z1 = line_.position0.z + lx1;
-
-    if(is_first_iteration_){
-        line_.position1 = glm::vec3(x, 0, z1);
-        line_.last_last_position1 = line_.position1;
-        line_.last_position1 = line_.position1;
-    }else{
-        line_.last_last_position1 = line_.last_position1;
-        line_.last_position1 = line_.position1;
-        line_.position1 = glm::vec3(x, 0, z1);
+void HodographSimulation::UpdateFrames(){
+    ProfileScope scope("UpdateFrames");
+    HodographFrame frame;
+    while(kinematics_thread_.PopFrame(frame)){
+        frame_ = frame;
+
+        hodograph_cache_.Push(frame_.sample);
+        // Warm-up samples would stay the peak of the whole run.
+        if(frame_.sample_valid){
+            phase_density_.Push(frame_.sample.position.z,
+                                frame_.sample.velocity.z);
+        }
+        if(full_history_enabled_)
+            full_history_.Push(frame_.sample);
+        if(spectrum_enabled_){
+            // Queued frames keep the omega and fast forward they were
+            // simulated with, the GUI settings may be newer.
+            spectrum_.Configure(frame_.angular_velocity, frame_.frame_interval,
+                                spectrum_settings_.harmonics);
+            spectrum_.Push(frame_.sample);
+        }
+        if(trace_writer_.is_open() || telemetry_.is_open()){
+            TraceRecord record = CreateTraceRecord(
+                    frame_.time, frame_.alpha, frame_.line_error_length,
+                    frame_.position0, frame_.sample);
+            if(trace_writer_.is_open())
+                trace_writer_.Append(record);
+            telemetry_.Publish(record);
+        }
+        if(settings_.diagnostics_enabled){
+            derivative_difference_history_.Push(
+                    frame_.derivative_difference);
+        }
+        if(settings_.sensitivity_enabled)
+            sensitivity_history_.Push(frame_.sensitivity);
     }
 
+    CycleRecord cycle;
+    while(kinematics_thread_.PopCycle(cycle))
+        cycle_history_.Push(cycle);
+    kinematics_thread_.ReadStatistics(statistics_);
 }
 
-void HodographSimulation::UpdateAlpha(){
-    alpha_ += angular_velocity_ * time_data_.time_delta;
-    ClampAlpha();
-}
-
-void HodographSimulation::ClampAlpha(){
-    if(alpha_ >= 2*M_PI)
-        alpha_ = 0;
+void HodographSimulation::UpdateReplay(){
+    ProfileScope scope("UpdateReplay");
+    std::size_t size = trace_reader_.size();
+    if(size == 0)
+        return;
+    const TraceRecord* records = trace_reader_.records();
+
+    // Follow the recorded time, unless the GUI moved the cursor.
+    if(replay_cursor_ >= size)
+        replay_cursor_ = size - 1;
+    if(replay_cursor_ != last_replay_cursor_)
+        replay_time_ = records[replay_cursor_].time;
+    replay_time_ += time_data_.time_delta;
+    while(replay_cursor_ + 1 < size
+          && records[replay_cursor_ + 1].time <= replay_time_)
+        replay_cursor_++;
+
+    last_replay_cursor_ = replay_cursor_;
+
+    const TraceRecord& record = records[replay_cursor_];
+    frame_.step = (long long)replay_cursor_;
+    frame_.time = record.time;
+    frame_.alpha = record.alpha;
+    frame_.line_error_length = record.line_error_length;
+    frame_.position0 = record.position0;
+    frame_.sample = GetTraceSample(record);
+    // Traces keep the sample only, drawn like the unfiltered joint.
+    frame_.position1 = frame_.sample.position;
 }
 
-void HodographSimulation::UpdateCache(){
-    auto& current = line_.position1;
-    auto& last = line_.last_position1;
-    auto& last_last = line_.last_last_position1;
+void HodographSimulation::UpdateEnsemble(){
+    ProfileScope scope("UpdateEnsemble");
+    ensemble_.parameters(settings_.parameters);
+    if(ensemble_.noise_stream().seed() != settings_.seed)
+        ensemble_.noise_stream().Reset(settings_.seed, 0);
+    ensemble_.Update(time_data_.time_delta);
+    ensemble_.UpdateStatistics();
 
-    float time_delta_sqr = time_data_.time_delta * time_data_.time_delta;
-    auto velocity = (current - last_last) / (2.0f * time_data_.time_delta);
-    auto acceleration = (current - (last*2.0f) + last_last)
-                          / (time_delta_sqr);
-
-    hodograph_cache_.positions.push_back(line_.position1);
-    hodograph_cache_.velocities.push_back(velocity);
-    hodograph_cache_.accelerations.push_back(acceleration);
-
-    hodograph_cache_.positions_z.push_back(line_.position1.z);
-    hodograph_cache_.velocities_z.push_back(velocity.z);
-    hodograph_cache_.accelerations_z.push_back(acceleration.z);
+    ensemble_history_.Push(ensemble_.statistics());
 }
 
+void HodographSimulation::UpdateSpectrum(){
+    ProfileScope scope("UpdateSpectrum");
+    fft_elapsed_ += time_data_.time_delta;
+    if(fft_elapsed_ < spectrum_settings_.fft_period)
+        return;
+    if(spectrum_.UpdateFft(hodograph_cache_, spectrum_settings_.fft_size))
+        fft_elapsed_ = 0;
+}
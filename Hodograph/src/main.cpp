@@ -109,6 +109,7 @@ int main() {
     auto game_factory
             = std::shared_ptr<ifx::GameFactory>(new ifx::GameFactory());
     auto game = game_factory->Create();
+    HodographFactory().WarmUp();
 
     auto game_object1 = CreateGameObjectFloor();
     auto game_object2 = CreateGameObjectLight();
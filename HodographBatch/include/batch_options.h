@@ -0,0 +1,94 @@
+#ifndef PROJECT_BATCH_OPTIONS_H
+#define PROJECT_BATCH_OPTIONS_H
+
+#include <kinematics/hodograph_parameters.h>
+#include <kinematics/crank_slider_analytic.h>
+#include <filters/derivative_filter.h>
+#include <linkage/linkage_mechanism.h>
+#include <sweep/parameter_grid.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+enum class OutputFormat{
+    CSV, TRACE, CYCLES
+};
+
+enum class Precision{
+    SINGLE, DOUBLE
+};
+
+struct BatchOptions{
+    long long steps = 1000;
+    float time_delta = 0.01f;
+
+    HodographParameters parameters;
+    DerivativeMethod derivative_method = DerivativeMethod::FINITE_DIFFERENCE;
+    FilterSettings filter;
+
+    /**
+     * Anything but CRANK_SLIDER runs a single mechanism through the
+     * linkage solver, CSV only.
+     */
+    MechanismSettings mechanism;
+
+    /**
+     * DOUBLE runs the slider column through CrankSliderKernel in double,
+     * crank angle included. Single CSV runs without a filter only.
+     */
+    Precision precision = Precision::SINGLE;
+
+    /**
+     * Adds the derivatives of position, velocity and acceleration with
+     * respect to radius, line length and angular velocity to single runs.
+     */
+    bool sensitivities = false;
+
+    /**
+     * Seed of the rod length noise, written to every output.
+     */
+    uint64_t seed = 0;
+
+    /**
+     * Number of ensemble members, 0 runs a single mechanism.
+     */
+    long long ensemble = 0;
+
+    /**
+     * Swept ranges, count 0 keeps the single value from parameters.
+     */
+    SweepRange sweep_angular_velocity = SweepRange(0, 0, 0);
+    SweepRange sweep_radius = SweepRange(0, 0, 0);
+    SweepRange sweep_line_length = SweepRange(0, 0, 0);
+    SweepRange sweep_error = SweepRange(0, 0, 0);
+    unsigned int threads = 0;
+
+    bool sweep() const {
+        return sweep_angular_velocity.count > 0 || sweep_radius.count > 0
+               || sweep_line_length.count > 0 || sweep_error.count > 0;
+    }
+
+    OutputFormat format = OutputFormat::CSV;
+    std::string output_path;
+
+    /**
+     * Trace file converted to CSV instead of running a simulation.
+     */
+    std::string replay_path;
+
+    /**
+     * --help was given, usage went to stdout and nothing runs.
+     */
+    bool help = false;
+};
+
+/**
+ * Parses command line arguments into options.
+ * Returns false and prints usage on invalid input.
+ */
+bool ParseBatchOptions(int argc, char** argv, BatchOptions& options);
+
+void PrintBatchUsage(const char* program, FILE* file = stderr);
+
+#endif //PROJECT_BATCH_OPTIONS_H
@@ -0,0 +1,31 @@
+#ifndef PROJECT_BATCH_RUNS_H
+#define PROJECT_BATCH_RUNS_H
+
+#include <batch_options.h>
+
+#include <cstdio>
+
+/**
+ * Each run writes CSV with a "# seed=N" comment and a header line to file
+ * and returns the process exit code. RunSingleTrace writes a binary trace
+ * to options.output_path instead, the seed goes to the trace header.
+ * RunSingleCycles writes one line per crank revolution instead of one
+ * per step. RunSingleKernel steps the slider column through
+ * CrankSliderKernel in double instead of HodographKinematics. RunLinkage
+ * runs options.mechanism through the linkage solver and reports steps
+ * without an assembly on stderr.
+ */
+inline void WriteSeed(FILE* file, uint64_t seed){
+    fprintf(file, "# seed=%llu\n", (unsigned long long)seed);
+}
+
+int RunSingle(const BatchOptions& options, FILE* file);
+int RunSingleKernel(const BatchOptions& options, FILE* file);
+int RunSingleTrace(const BatchOptions& options);
+int RunSingleCycles(const BatchOptions& options, FILE* file);
+int RunLinkage(const BatchOptions& options, FILE* file);
+int RunReplay(const BatchOptions& options, FILE* file);
+int RunEnsemble(const BatchOptions& options, FILE* file);
+int RunSweep(const BatchOptions& options, FILE* file);
+
+#endif //PROJECT_BATCH_RUNS_H
@@ -0,0 +1,322 @@
+#include "batch_options.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+bool ParseFloat(const char* value, float& result){
+    char* end = nullptr;
+    result = strtof(value, &end);
+    return end != value && *end == '\0';
+}
+
+bool ParseLong(const char* value, long long& result){
+    char* end = nullptr;
+    result = strtoll(value, &end, 10);
+    return end != value && *end == '\0' && result >= 0;
+}
+
+bool ParseSeed(const char* value, uint64_t& result){
+    char* end = nullptr;
+    result = strtoull(value, &end, 0);
+    return end != value && *end == '\0' && value[0] != '-';
+}
+
+bool ParseDerivativeMethod(const char* value, DerivativeMethod& method){
+    if(strcmp(value, "finite") == 0)
+        method = DerivativeMethod::FINITE_DIFFERENCE;
+    else if(strcmp(value, "analytic") == 0)
+        method = DerivativeMethod::ANALYTIC;
+    else
+        return false;
+    return true;
+}
+
+bool ParseSwitch(const char* value, bool& result){
+    if(strcmp(value, "on") == 0)
+        result = true;
+    else if(strcmp(value, "off") == 0)
+        result = false;
+    else
+        return false;
+    return true;
+}
+
+/**
+ * none, sg:HALF_WINDOW:ORDER, ma:HALF_WINDOW or ema:SMOOTHING.
+ */
+bool ParseFilter(const char* value, FilterSettings& filter){
+    if(strcmp(value, "none") == 0){
+        filter.type = FilterType::NONE;
+        return true;
+    }
+    char* end = nullptr;
+    if(strncmp(value, "sg:", 3) == 0){
+        filter.type = FilterType::SAVITZKY_GOLAY;
+        filter.half_window = (int)strtol(value + 3, &end, 10);
+        if(end == value + 3 || *end != ':')
+            return false;
+        const char* order = end + 1;
+        filter.order = (int)strtol(order, &end, 10);
+        return end != order && *end == '\0' && filter.half_window >= 1
+               && filter.half_window <= FilterSettings::MAX_HALF_WINDOW
+               && filter.order >= 2
+               && filter.order <= FilterSettings::MaxOrder(
+                       filter.half_window);
+    }
+    if(strncmp(value, "ma:", 3) == 0){
+        filter.type = FilterType::MOVING_AVERAGE;
+        filter.half_window = (int)strtol(value + 3, &end, 10);
+        return end != value + 3 && *end == '\0' && filter.half_window >= 1
+               && filter.half_window <= FilterSettings::MAX_HALF_WINDOW;
+    }
+    if(strncmp(value, "ema:", 4) == 0){
+        filter.type = FilterType::EXPONENTIAL;
+        return ParseFloat(value + 4, filter.smoothing)
+               && filter.smoothing > 0 && filter.smoothing <= 1;
+    }
+    return false;
+}
+
+/**
+ * crank-slider, offset:OFFSET, four-bar or two-loop.
+ */
+bool ParseMechanism(const char* value, MechanismSettings& mechanism){
+    if(strcmp(value, "crank-slider") == 0)
+        mechanism.type = MechanismType::CRANK_SLIDER;
+    else if(strcmp(value, "four-bar") == 0)
+        mechanism.type = MechanismType::FOUR_BAR;
+    else if(strcmp(value, "two-loop") == 0)
+        mechanism.type = MechanismType::TWO_LOOP;
+    else if(strncmp(value, "offset:", 7) == 0){
+        mechanism.type = MechanismType::OFFSET_SLIDER_CRANK;
+        return ParseFloat(value + 7, mechanism.offset);
+    }
+    else
+        return false;
+    return true;
+}
+
+bool ParsePrecision(const char* value, Precision& precision){
+    if(strcmp(value, "float") == 0)
+        precision = Precision::SINGLE;
+    else if(strcmp(value, "double") == 0)
+        precision = Precision::DOUBLE;
+    else
+        return false;
+    return true;
+}
+
+bool ParseFormat(const char* value, OutputFormat& format){
+    if(strcmp(value, "csv") == 0)
+        format = OutputFormat::CSV;
+    else if(strcmp(value, "trace") == 0)
+        format = OutputFormat::TRACE;
+    else if(strcmp(value, "cycles") == 0)
+        format = OutputFormat::CYCLES;
+    else
+        return false;
+    return true;
+}
+
+bool ParseRange(const char* value, SweepRange& range){
+    char* end = nullptr;
+    range.min = strtof(value, &end);
+    if(end == value || *end != ':')
+        return false;
+    const char* max = end + 1;
+    range.max = strtof(max, &end);
+    if(end == max || *end != ':')
+        return false;
+    long long count;
+    if(!ParseLong(end + 1, count) || count < 1)
+        return false;
+    range.count = (int)count;
+    return true;
+}
+
+}
+
+bool ParseBatchOptions(int argc, char** argv, BatchOptions& options){
+    for(int i = 1; i < argc; i++){
+        const char* name = argv[i];
+        if(strcmp(name, "--help") == 0 || strcmp(name, "-h") == 0){
+            PrintBatchUsage(argv[0], stdout);
+            options.help = true;
+            return true;
+        }
+        if(i + 1 >= argc){
+            fprintf(stderr, "Missing value for %s\n", name);
+            PrintBatchUsage(argv[0]);
+            return false;
+        }
+        const char* value = argv[++i];
+
+        bool valid = true;
+        if(strcmp(name, "--steps") == 0)
+            valid = ParseLong(value, options.steps);
+        else if(strcmp(name, "--dt") == 0)
+            valid = ParseFloat(value, options.time_delta)
+                    && options.time_delta > 0;
+        else if(strcmp(name, "--angular-velocity") == 0)
+            valid = ParseFloat(value, options.parameters.angular_velocity);
+        else if(strcmp(name, "--radius") == 0)
+            valid = ParseFloat(value, options.parameters.radius);
+        else if(strcmp(name, "--line-length") == 0)
+            valid = ParseFloat(value, options.parameters.line_length);
+        else if(strcmp(name, "--error") == 0)
+            valid = ParseFloat(value, options.parameters.error)
+                    && options.parameters.error >= 0;
+        else if(strcmp(name, "--seed") == 0)
+            valid = ParseSeed(value, options.seed);
+        else if(strcmp(name, "--derivatives") == 0)
+            valid = ParseDerivativeMethod(value, options.derivative_method);
+        else if(strcmp(name, "--precision") == 0)
+            valid = ParsePrecision(value, options.precision);
+        else if(strcmp(name, "--filter") == 0)
+            valid = ParseFilter(value, options.filter);
+        else if(strcmp(name, "--sensitivities") == 0)
+            valid = ParseSwitch(value, options.sensitivities);
+        else if(strcmp(name, "--mechanism") == 0)
+            valid = ParseMechanism(value, options.mechanism);
+        else if(strcmp(name, "--ground") == 0)
+            valid = ParseFloat(value, options.mechanism.ground)
+                    && options.mechanism.ground > 0;
+        else if(strcmp(name, "--rocker") == 0)
+            valid = ParseFloat(value, options.mechanism.rocker)
+                    && options.mechanism.rocker > 0;
+        else if(strcmp(name, "--output-length") == 0)
+            valid = ParseFloat(value, options.mechanism.output_length)
+                    && options.mechanism.output_length > 0;
+        else if(strcmp(name, "--ensemble") == 0)
+            valid = ParseLong(value, options.ensemble);
+        else if(strcmp(name, "--sweep-angular-velocity") == 0)
+            valid = ParseRange(value, options.sweep_angular_velocity);
+        else if(strcmp(name, "--sweep-radius") == 0)
+            valid = ParseRange(value, options.sweep_radius);
+        else if(strcmp(name, "--sweep-line-length") == 0)
+            valid = ParseRange(value, options.sweep_line_length);
+        else if(strcmp(name, "--sweep-error") == 0)
+            valid = ParseRange(value, options.sweep_error);
+        else if(strcmp(name, "--threads") == 0){
+            long long threads;
+            valid = ParseLong(value, threads);
+            options.threads = (unsigned int)threads;
+        }
+        else if(strcmp(name, "--format") == 0)
+            valid = ParseFormat(value, options.format);
+        else if(strcmp(name, "--output") == 0)
+            options.output_path = value;
+        else if(strcmp(name, "--replay") == 0)
+            options.replay_path = value;
+        else{
+            fprintf(stderr, "Unknown option %s\n", name);
+            PrintBatchUsage(argv[0]);
+            return false;
+        }
+
+        if(!valid){
+            fprintf(stderr, "Invalid value for %s: %s\n", name, value);
+            return false;
+        }
+    }
+    if(options.format == OutputFormat::TRACE && options.output_path.empty()){
+        fprintf(stderr, "--format trace needs --output\n");
+        return false;
+    }
+    bool single = !options.sweep() && options.ensemble == 0;
+    if(!single && options.format != OutputFormat::CSV){
+        fprintf(stderr, "--format trace and cycles support single runs "
+                "only\n");
+        return false;
+    }
+    if(options.sensitivities
+       && (!single || options.format != OutputFormat::CSV)){
+        fprintf(stderr, "--sensitivities supports single CSV runs only\n");
+        return false;
+    }
+    bool filtered = options.filter.type != FilterType::NONE;
+    if(options.ensemble > 0
+       && (filtered || options.derivative_method
+                       != DerivativeMethod::FINITE_DIFFERENCE)){
+        fprintf(stderr, "--ensemble supports unfiltered finite differences "
+                "only\n");
+        return false;
+    }
+    bool linkage = options.mechanism.type != MechanismType::CRANK_SLIDER;
+    if(linkage && (options.format != OutputFormat::CSV || options.sweep()
+                   || options.ensemble > 0 || options.sensitivities)){
+        fprintf(stderr, "--mechanism supports single CSV runs only\n");
+        return false;
+    }
+    bool kernel = options.precision == Precision::DOUBLE;
+    if(kernel && (linkage || options.format != OutputFormat::CSV
+                  || options.sweep() || options.ensemble > 0
+                  || options.sensitivities
+                  || options.filter.type != FilterType::NONE)){
+        fprintf(stderr, "--precision double supports single unfiltered "
+                "crank-slider CSV runs only\n");
+        return false;
+    }
+    return true;
+}
+
+void PrintBatchUsage(const char* program, FILE* file){
+    fprintf(file,
+            "Usage: %s [options]\n"
+            "  --steps N                number of simulation steps\n"
+            "  --dt SECONDS             time delta of a single step\n"
+            "  --angular-velocity W     crank angular velocity\n"
+            "  --radius R               crank radius\n"
+            "  --line-length L          connecting rod length\n"
+            "  --error SIGMA            standard deviation of rod length error\n"
+            "  --seed N                 noise seed (default: 0), "
+            "same seed gives the same noise\n"
+            "  --derivatives METHOD     finite (default) or analytic\n"
+            "  --precision TYPE         float (default) or double, "
+            "double runs the\n"
+            "                           slider kernel, single CSV runs "
+            "only\n"
+            "  --filter FILTER          smooths finite differences: none "
+            "(default),\n"
+            "                           sg:HALF_WINDOW:ORDER, ma:HALF_WINDOW "
+            "or ema:SMOOTHING,\n"
+            "                           output lags by the filter delay, "
+            "HALF_WINDOW <= 64,\n"
+            "                           ORDER <= min(2 * HALF_WINDOW, 12)\n"
+            "  --sensitivities on|off   add d/d(radius, line length, "
+            "angular velocity)\n"
+            "                           columns to single CSV runs "
+            "(default: off)\n"
+            "  --mechanism TYPE         crank-slider (default), "
+            "offset:OFFSET, four-bar\n"
+            "                           or two-loop, solved by the linkage "
+            "solver\n"
+            "  --ground G               four-bar rocker pivot distance "
+            "(default: 3)\n"
+            "  --rocker R               four-bar rocker length "
+            "(default: 2.5)\n"
+            "  --output-length L        two-loop output rod length "
+            "(default: 3)\n"
+            "  --ensemble N             run N noisy mechanisms, "
+            "write per-step statistics,\n"
+            "                           finite differences without a "
+            "filter only\n"
+            "  --sweep-angular-velocity MIN:MAX:COUNT\n"
+            "  --sweep-radius MIN:MAX:COUNT\n"
+            "  --sweep-line-length MIN:MAX:COUNT\n"
+            "  --sweep-error MIN:MAX:COUNT\n"
+            "                           sweep the grid of all ranges, "
+            "write metrics per configuration\n"
+            "  --threads N              sweep worker threads "
+            "(default: all cores)\n"
+            "  --format FORMAT          csv (default), trace, "
+            "a binary trace of a single run,\n"
+            "                           or cycles, one line per "
+            "revolution of a single run\n"
+            "  --output PATH            output file (default: stdout)\n"
+            "  --replay PATH            convert a binary trace to CSV\n",
+            program);
+}
@@ -0,0 +1,46 @@
+#include "batch_runs.h"
+
+#include <kinematics/hodograph_ensemble.h>
+
+namespace {
+
+void WriteStatisticsHeader(FILE* file, const char* name){
+    fprintf(file, ",%s_mean,%s_variance,%s_p05,%s_p50,%s_p95,%s_invalid",
+            name, name, name, name, name, name);
+}
+
+void WriteStatistics(FILE* file, const SummaryStatistics& statistics){
+    fprintf(file, ",%.9g,%.9g,%.9g,%.9g,%.9g,%zu",
+            statistics.mean, statistics.variance,
+            statistics.p05, statistics.p50, statistics.p95,
+            statistics.invalid);
+}
+
+}
+
+int RunEnsemble(const BatchOptions& options, FILE* file){
+    HodographEnsemble ensemble((std::size_t)options.ensemble);
+    ensemble.parameters(options.parameters);
+    ensemble.noise_stream().Reset(options.seed, 0);
+
+    WriteSeed(file, options.seed);
+    fprintf(file, "step,time");
+    WriteStatisticsHeader(file, "position");
+    WriteStatisticsHeader(file, "velocity");
+    WriteStatisticsHeader(file, "acceleration");
+    fprintf(file, "\n");
+
+    for(long long step = 0; step < options.steps; step++){
+        ensemble.Update(options.time_delta);
+        ensemble.UpdateStatistics();
+
+        const EnsembleStep& statistics = ensemble.statistics();
+        fprintf(file, "%lld,%.9g", step,
+                (step + 1) * (double)options.time_delta);
+        WriteStatistics(file, statistics.position);
+        WriteStatistics(file, statistics.velocity);
+        WriteStatistics(file, statistics.acceleration);
+        fprintf(file, "\n");
+    }
+    return 0;
+}
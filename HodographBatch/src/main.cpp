@@ -0,0 +1,44 @@
+#include <batch_options.h>
+#include <batch_runs.h>
+
+#include <cstdio>
+
+int main(int argc, char** argv) {
+    BatchOptions options;
+    if(!ParseBatchOptions(argc, argv, options))
+        return 1;
+    if(options.help)
+        return 0;
+
+    if(options.replay_path.empty() && options.format == OutputFormat::TRACE)
+        return RunSingleTrace(options);
+
+    FILE* file = stdout;
+    if(!options.output_path.empty()){
+        file = fopen(options.output_path.c_str(), "w");
+        if(!file){
+            perror(options.output_path.c_str());
+            return 1;
+        }
+    }
+
+    int result;
+    if(!options.replay_path.empty())
+        result = RunReplay(options, file);
+    else if(options.sweep())
+        result = RunSweep(options, file);
+    else if(options.ensemble > 0)
+        result = RunEnsemble(options, file);
+    else if(options.mechanism.type != MechanismType::CRANK_SLIDER)
+        result = RunLinkage(options, file);
+    else if(options.precision == Precision::DOUBLE)
+        result = RunSingleKernel(options, file);
+    else if(options.format == OutputFormat::CYCLES)
+        result = RunSingleCycles(options, file);
+    else
+        result = RunSingle(options, file);
+
+    if(file != stdout)
+        fclose(file);
+    return result;
+}
@@ -0,0 +1,232 @@
+#include "batch_runs.h"
+
+#include <kinematics/crank_slider_kernel.h>
+#include <kinematics/hodograph_kinematics.h>
+#include <linkage/linkage_kinematics.h>
+#include <trace/trace_reader.h>
+#include <trace/trace_writer.h>
+
+namespace {
+
+const char* SENSITIVITY_NAMES[SENSITIVITY_PARAMETER_COUNT] = {
+        "radius", "line_length", "angular_velocity"};
+
+void WriteHeader(FILE* file, bool sensitivities = false){
+    fprintf(file, "step,time,alpha,line_error_length,"
+            "position_x,position_y,position_z,"
+            "velocity_x,velocity_y,velocity_z,"
+            "acceleration_x,acceleration_y,acceleration_z");
+    for(int i = 0; sensitivities && i < SENSITIVITY_PARAMETER_COUNT; i++){
+        const char* name = SENSITIVITY_NAMES[i];
+        fprintf(file, ",dposition_d%s,dvelocity_d%s,dacceleration_d%s",
+                name, name, name);
+    }
+    fprintf(file, "\n");
+}
+
+void WriteSample(FILE* file, long long step, double time,
+                 float alpha, float line_error_length,
+                 const HodographSample& sample,
+                 const HodographSensitivity* sensitivity = nullptr){
+    fprintf(file, "%lld,%.9g,%.9g,%.9g,"
+                    "%.9g,%.9g,%.9g,"
+                    "%.9g,%.9g,%.9g,"
+                    "%.9g,%.9g,%.9g",
+            step, time, alpha, line_error_length,
+            sample.position.x, sample.position.y, sample.position.z,
+            sample.velocity.x, sample.velocity.y, sample.velocity.z,
+            sample.acceleration.x, sample.acceleration.y,
+            sample.acceleration.z);
+    for(int i = 0; sensitivity && i < SENSITIVITY_PARAMETER_COUNT; i++){
+        const SliderSensitivity& parameter = sensitivity->parameters[i];
+        fprintf(file, ",%.9g,%.9g,%.9g", parameter.position,
+                parameter.velocity, parameter.acceleration);
+    }
+    fprintf(file, "\n");
+}
+
+void WriteCycleHeader(FILE* file){
+    fprintf(file, "cycle,start_time,period,samples,stroke,"
+            "top_position,top_time,bottom_position,bottom_time,"
+            "peak_velocity,peak_velocity_alpha,"
+            "peak_acceleration,peak_acceleration_alpha,error_rms\n");
+}
+
+void WriteCycle(FILE* file, const CycleRecord& cycle){
+    fprintf(file, "%u,%.9g,%.9g,%u,%.9g,"
+                    "%.9g,%.9g,%.9g,%.9g,"
+                    "%.9g,%.9g,"
+                    "%.9g,%.9g,%.9g\n",
+            cycle.index, cycle.start_time, cycle.period, cycle.samples,
+            cycle.stroke(),
+            cycle.top_position, cycle.top_time,
+            cycle.bottom_position, cycle.bottom_time,
+            cycle.peak_velocity, cycle.peak_velocity_alpha,
+            cycle.peak_acceleration, cycle.peak_acceleration_alpha,
+            cycle.error_rms);
+}
+
+/**
+ * Same columns as WriteSample, in the layout of HodographKinematics, with
+ * enough digits for double.
+ */
+template<typename Kernel>
+void WriteKernelSample(FILE* file, long long step, double time,
+                       const Kernel& kernel){
+    const typename Kernel::State& state = kernel.state();
+    fprintf(file, "%lld,%.17g,%.17g,%.17g,"
+                    "%.17g,0,%.17g,"
+                    "0,0,%.17g,"
+                    "0,0,%.17g\n",
+            step, time, (double)kernel.alpha(),
+            (double)kernel.line_error_length(),
+            -0.01, (double)state.position,
+            (double)state.velocity,
+            (double)state.acceleration);
+}
+
+template<DerivativeMethod Method, bool Noise>
+int RunKernel(const BatchOptions& options, FILE* file){
+    typedef CrankSliderKernel<double, Method, Noise> Kernel;
+    Kernel kernel(options.parameters, options.time_delta);
+    NoiseStream noise_stream(options.seed, 0);
+
+    WriteSeed(file, options.seed);
+    WriteHeader(file);
+    for(long long step = 0; step < options.steps; step++){
+        kernel.Step(noise_stream);
+        WriteKernelSample(file, step, (step + 1) * (double)options.time_delta,
+                          kernel);
+    }
+    return 0;
+}
+
+void InitKinematics(const BatchOptions& options,
+                    HodographKinematics& kinematics){
+    kinematics.parameters(options.parameters);
+    kinematics.cache_enabled(false);
+    kinematics.derivative_method(options.derivative_method);
+    kinematics.filter_settings(options.filter);
+    kinematics.sensitivity_enabled(options.sensitivities);
+    kinematics.noise_stream().Reset(options.seed, 0);
+}
+
+}
+
+int RunSingle(const BatchOptions& options, FILE* file){
+    HodographKinematics kinematics(1);
+    InitKinematics(options, kinematics);
+
+    WriteSeed(file, options.seed);
+    WriteHeader(file, options.sensitivities);
+    for(long long step = 0; step < options.steps; step++){
+        kinematics.Update(options.time_delta);
+        WriteSample(file, step, (step + 1) * (double)options.time_delta,
+                    kinematics.alpha(), kinematics.line_error_length(),
+                    kinematics.sample(),
+                    options.sensitivities ? &kinematics.sensitivity()
+                                          : nullptr);
+    }
+    return 0;
+}
+
+int RunSingleKernel(const BatchOptions& options, FILE* file){
+    // A kernel without noise never draws from the stream, with an error of
+    // 0 the rod length is the same either way.
+    bool noise = options.parameters.error != 0;
+    const DerivativeMethod analytic = DerivativeMethod::ANALYTIC;
+    const DerivativeMethod finite = DerivativeMethod::FINITE_DIFFERENCE;
+    if(options.derivative_method == analytic){
+        return noise ? RunKernel<analytic, true>(options, file)
+                     : RunKernel<analytic, false>(options, file);
+    }
+    return noise ? RunKernel<finite, true>(options, file)
+                 : RunKernel<finite, false>(options, file);
+}
+
+int RunSingleCycles(const BatchOptions& options, FILE* file){
+    HodographKinematics kinematics(1);
+    InitKinematics(options, kinematics);
+    kinematics.statistics_enabled(false);
+    kinematics.cycles_enabled(true);
+
+    WriteSeed(file, options.seed);
+    WriteCycleHeader(file);
+    for(long long step = 0; step < options.steps; step++){
+        kinematics.Update(options.time_delta);
+        if(kinematics.cycle_completed())
+            WriteCycle(file, kinematics.cycles().last());
+    }
+    return 0;
+}
+
+int RunLinkage(const BatchOptions& options, FILE* file){
+    LinkageKinematics kinematics(1);
+    kinematics.cache_enabled(false);
+    kinematics.parameters(options.parameters);
+    kinematics.mechanism(options.mechanism);
+    kinematics.noise_stream().Reset(options.seed, 0);
+
+    WriteSeed(file, options.seed);
+    WriteHeader(file);
+    for(long long step = 0; step < options.steps; step++){
+        kinematics.Update(options.time_delta);
+        WriteSample(file, step, (step + 1) * (double)options.time_delta,
+                    kinematics.alpha(), kinematics.line_error_length(),
+                    kinematics.sample());
+    }
+    if(kinematics.singular_steps() > 0){
+        fprintf(stderr, "%s: %llu steps without an assembly\n",
+                MechanismName(options.mechanism.type),
+                kinematics.singular_steps());
+    }
+    return 0;
+}
+
+int RunSingleTrace(const BatchOptions& options){
+    HodographKinematics kinematics(1);
+    InitKinematics(options, kinematics);
+
+    TraceWriter writer;
+    if(!writer.Open(options.output_path,
+                    CreateTraceHeader(options.parameters, options.seed))){
+        fprintf(stderr, "%s\n", writer.error().c_str());
+        return 1;
+    }
+
+    for(long long step = 0; step < options.steps; step++){
+        kinematics.Update(options.time_delta);
+        writer.AppendBlocking(
+                CreateTraceRecord((step + 1) * (double)options.time_delta,
+                                  kinematics.alpha(),
+                                  kinematics.line_error_length(),
+                                  kinematics.line().position0,
+                                  kinematics.sample()));
+    }
+    writer.Close();
+
+    if(!writer.error().empty()){
+        fprintf(stderr, "%s\n", writer.error().c_str());
+        return 1;
+    }
+    return 0;
+}
+
+int RunReplay(const BatchOptions& options, FILE* file){
+    TraceReader reader;
+    if(!reader.Open(options.replay_path)){
+        fprintf(stderr, "%s\n", reader.error().c_str());
+        return 1;
+    }
+
+    const TraceRecord* records = reader.records();
+    WriteSeed(file, reader.header().seed);
+    WriteHeader(file);
+    for(std::size_t i = 0; i < reader.size(); i++){
+        const TraceRecord& record = records[i];
+        WriteSample(file, (long long)i, record.time,
+                    record.alpha, record.line_error_length,
+                    GetTraceSample(record));
+    }
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include "batch_runs.h"
+
+#include <sweep/parameter_sweep.h>
+#include <threading/work_stealing_pool.h>
+
+#include <chrono>
+
+int RunSweep(const BatchOptions& options, FILE* file){
+    ParameterGrid grid(options.parameters);
+    if(options.sweep_angular_velocity.count > 0)
+        grid.angular_velocity = options.sweep_angular_velocity;
+    if(options.sweep_radius.count > 0)
+        grid.radius = options.sweep_radius;
+    if(options.sweep_line_length.count > 0)
+        grid.line_length = options.sweep_line_length;
+    if(options.sweep_error.count > 0)
+        grid.error = options.sweep_error;
+
+    WorkStealingPool pool(options.threads);
+    ParameterSweep sweep(grid, options.steps, options.time_delta,
+                         options.seed);
+    sweep.derivative_method(options.derivative_method);
+    sweep.filter_settings(options.filter);
+
+    WriteSeed(file, options.seed);
+    fprintf(file, "index,angular_velocity,radius,line_length,error,"
+            "buildable,invalid_steps,peak_acceleration,rms_acceleration,"
+            "min_velocity,max_velocity,velocity_range\n");
+
+    auto start = std::chrono::steady_clock::now();
+    sweep.Run(pool, [file](const SweepResult& result){
+        fprintf(file, "%zu,%.9g,%.9g,%.9g,%.9g,%d,%lld,%.9g,%.9g,"
+                "%.9g,%.9g,%.9g\n",
+                result.index,
+                result.parameters.angular_velocity,
+                result.parameters.radius,
+                result.parameters.line_length,
+                result.parameters.error,
+                result.buildable ? 1 : 0,
+                result.invalid_steps,
+                result.peak_acceleration,
+                result.rms_acceleration,
+                result.min_velocity,
+                result.max_velocity,
+                result.max_velocity - result.min_velocity);
+        fflush(file);
+    });
+    std::chrono::duration<double> elapsed
+            = std::chrono::steady_clock::now() - start;
+
+    fprintf(stderr, "%zu configurations on %u threads in %.3f s\n",
+            grid.size(), pool.thread_count(), elapsed.count());
+    return 0;
+}
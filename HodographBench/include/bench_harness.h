@@ -0,0 +1,89 @@
+#ifndef PROJECT_BENCH_HARNESS_H
+#define PROJECT_BENCH_HARNESS_H
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * Runs the measured code iterations times.
+ */
+typedef std::function<void(long long iterations)> BenchmarkBody;
+
+/**
+ * Builds the state of a benchmark outside of the measured time and
+ * returns the body that uses it.
+ */
+typedef std::function<BenchmarkBody()> BenchmarkSetup;
+
+/**
+ * Largest absolute error of the benchmarked computation against a
+ * reference, evaluated once outside of the measured time.
+ */
+typedef std::function<double()> BenchmarkAccuracy;
+
+enum class BenchmarkSuite{
+    MICRO, MACRO
+};
+
+struct Benchmark{
+    std::string name;
+    BenchmarkSuite suite;
+    BenchmarkSetup setup;
+    /**
+     * Mechanism steps advanced by one iteration of a macro-benchmark,
+     * e.g. the member count of an ensemble. Ignored by micro-benchmarks.
+     */
+    long long operations_per_step;
+    /**
+     * Optional, empty for benchmarks without a reference.
+     */
+    BenchmarkAccuracy accuracy;
+};
+
+/**
+ * One measured run. An operation is one iteration of the body, for
+ * macro-benchmarks one simulated step of one mechanism.
+ */
+struct BenchmarkResult{
+    std::string name;
+    BenchmarkSuite suite;
+    long long operations;
+    double seconds;
+    unsigned long long allocations;
+    unsigned long long allocated_bytes;
+    /**
+     * High-water mark of the resident set while the benchmark ran.
+     */
+    unsigned long long peak_rss_bytes;
+    /**
+     * Result of Benchmark::accuracy, NaN if the benchmark has none.
+     */
+    double max_error;
+};
+
+/**
+ * Doubles the iteration count until a run takes at least min_time seconds.
+ */
+BenchmarkResult RunMicroBenchmark(const Benchmark& benchmark,
+                                  double min_time);
+
+/**
+ * Runs steps mechanism steps once, rounded to whole iterations.
+ */
+BenchmarkResult RunMacroBenchmark(const Benchmark& benchmark,
+                                  long long steps);
+
+void WriteBenchmarkJson(FILE* file,
+                        const std::vector<BenchmarkResult>& results);
+
+/**
+ * Keeps the compiler from removing the computation of value.
+ */
+template<typename T>
+inline void DoNotOptimize(const T& value){
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+#endif //PROJECT_BENCH_HARNESS_H
@@ -0,0 +1,36 @@
+#ifndef PROJECT_BENCH_OPTIONS_H
+#define PROJECT_BENCH_OPTIONS_H
+
+#include <string>
+
+struct BenchOptions{
+    bool micro = true;
+    bool macro = true;
+
+    /**
+     * Only benchmarks whose name contains filter are run.
+     */
+    std::string filter;
+
+    /**
+     * Micro-benchmarks repeat until a single run takes min_time seconds.
+     */
+    double min_time = 0.5;
+
+    /**
+     * Simulation steps of every macro-benchmark.
+     */
+    long long steps = 1000000;
+
+    std::string output_path;
+};
+
+/**
+ * Parses command line arguments into options.
+ * Returns false and prints usage on invalid input.
+ */
+bool ParseBenchOptions(int argc, char** argv, BenchOptions& options);
+
+void PrintBenchUsage(const char* program);
+
+#endif //PROJECT_BENCH_OPTIONS_H
@@ -0,0 +1,18 @@
+#ifndef PROJECT_BENCHMARKS_H
+#define PROJECT_BENCHMARKS_H
+
+#include <bench_harness.h>
+
+#include <vector>
+
+/**
+ * Parts of a single simulation step and of the graph data preparation.
+ */
+void AddMicroBenchmarks(std::vector<Benchmark>& benchmarks);
+
+/**
+ * Sustained runs, as the GUI and the batch runner drive the kinematics.
+ */
+void AddMacroBenchmarks(std::vector<Benchmark>& benchmarks);
+
+#endif //PROJECT_BENCHMARKS_H
@@ -0,0 +1,172 @@
+#include "bench_harness.h"
+
+#include <memory/allocation_counter.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <sys/resource.h>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * Linux resets VmHWM to the current RSS when "5" is written to clear_refs.
+ */
+void ResetPeakRss(){
+    FILE* file = fopen("/proc/self/clear_refs", "w");
+    if(!file)
+        return;
+    fputs("5", file);
+    fclose(file);
+}
+
+unsigned long long PeakRssBytes(){
+    FILE* file = fopen("/proc/self/status", "r");
+    if(file){
+        char line[256];
+        unsigned long long kilobytes = 0;
+        bool found = false;
+        while(!found && fgets(line, sizeof(line), file))
+            found = sscanf(line, "VmHWM: %llu kB", &kilobytes) == 1;
+        fclose(file);
+        if(found)
+            return kilobytes * 1024;
+    }
+
+    // Peak of the whole process, cannot be reset.
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (unsigned long long)usage.ru_maxrss * 1024;
+}
+
+BenchmarkResult Measure(const Benchmark& benchmark,
+                        const BenchmarkBody& body, long long iterations){
+    BenchmarkResult result;
+    result.name = benchmark.name;
+    result.suite = benchmark.suite;
+    result.operations = iterations;
+
+    AllocationCounter allocations;
+    Clock::time_point start = Clock::now();
+    body(iterations);
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    result.seconds = elapsed.count();
+    result.allocations = allocations.count();
+    result.allocated_bytes = allocations.bytes();
+    result.peak_rss_bytes = PeakRssBytes();
+    result.max_error = NAN;
+    return result;
+}
+
+const char* SuiteName(BenchmarkSuite suite){
+    return suite == BenchmarkSuite::MICRO ? "micro" : "macro";
+}
+
+double PerOperation(double value, long long operations){
+    return operations > 0 ? value / operations : 0;
+}
+
+bool IsOptimized(){
+#if defined(__OPTIMIZE__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+}
+
+BenchmarkResult RunMicroBenchmark(const Benchmark& benchmark,
+                                  double min_time){
+    ResetPeakRss();
+    BenchmarkBody body = benchmark.setup();
+
+    long long iterations = 1;
+    while(true){
+        BenchmarkResult result = Measure(benchmark, body, iterations);
+        if(result.seconds >= min_time){
+            if(benchmark.accuracy)
+                result.max_error = benchmark.accuracy();
+            return result;
+        }
+
+        // Aim slightly past min_time, but never grow more than 10x at once.
+        double scale = result.seconds > 0
+                       ? 1.2 * min_time / result.seconds : 10;
+        if(scale > 10)
+            scale = 10;
+        if(scale < 2)
+            scale = 2;
+        iterations = (long long)(iterations * scale);
+    }
+}
+
+BenchmarkResult RunMacroBenchmark(const Benchmark& benchmark,
+                                  long long steps){
+    ResetPeakRss();
+    BenchmarkBody body = benchmark.setup();
+
+    long long iterations = steps / benchmark.operations_per_step;
+    if(iterations < 1)
+        iterations = 1;
+
+    BenchmarkResult result = Measure(benchmark, body, iterations);
+    result.operations = iterations * benchmark.operations_per_step;
+    if(benchmark.accuracy)
+        result.max_error = benchmark.accuracy();
+    return result;
+}
+
+void WriteBenchmarkJson(FILE* file,
+                        const std::vector<BenchmarkResult>& results){
+    char date[32];
+    time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+    fprintf(file, "{\n");
+    fprintf(file, "  \"context\": {\n");
+    fprintf(file, "    \"date\": \"%s\",\n", date);
+    fprintf(file, "    \"compiler\": \"%s\",\n", __VERSION__);
+    fprintf(file, "    \"optimized\": %s,\n", IsOptimized() ? "true" : "false");
+#if defined(__AVX2__)
+    fprintf(file, "    \"simd\": \"avx2\"\n");
+#elif defined(__SSE2__)
+    fprintf(file, "    \"simd\": \"sse2\"\n");
+#else
+    fprintf(file, "    \"simd\": \"none\"\n");
+#endif
+    fprintf(file, "  },\n");
+
+    fprintf(file, "  \"benchmarks\": [");
+    for(std::size_t i = 0; i < results.size(); i++){
+        const BenchmarkResult& result = results[i];
+        double ns_per_operation
+                = PerOperation(result.seconds * 1e9, result.operations);
+
+        fprintf(file, "%s\n    {\n", i == 0 ? "" : ",");
+        fprintf(file, "      \"name\": \"%s\",\n", result.name.c_str());
+        fprintf(file, "      \"suite\": \"%s\",\n", SuiteName(result.suite));
+        fprintf(file, "      \"operations\": %lld,\n", result.operations);
+        fprintf(file, "      \"seconds\": %.9g,\n", result.seconds);
+        fprintf(file, "      \"ns_per_operation\": %.6g,\n",
+                ns_per_operation);
+        fprintf(file, "      \"operations_per_second\": %.6g,\n",
+                result.seconds > 0 ? result.operations / result.seconds : 0);
+        fprintf(file, "      \"allocations_per_operation\": %.6g,\n",
+                PerOperation((double)result.allocations, result.operations));
+        fprintf(file, "      \"bytes_allocated_per_operation\": %.6g,\n",
+                PerOperation((double)result.allocated_bytes,
+                             result.operations));
+        fprintf(file, "      \"peak_rss_bytes\": %llu%s\n",
+                result.peak_rss_bytes,
+                std::isnan(result.max_error) ? "" : ",");
+        if(!std::isnan(result.max_error))
+            fprintf(file, "      \"max_error\": %.6g\n", result.max_error);
+        fprintf(file, "    }");
+    }
+    fprintf(file, "\n  ]\n}\n");
+}
@@ -0,0 +1,96 @@
+#include "bench_options.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+bool ParseDouble(const char* value, double& result){
+    char* end = nullptr;
+    result = strtod(value, &end);
+    return end != value && *end == '\0' && result >= 0;
+}
+
+bool ParseLong(const char* value, long long& result){
+    char* end = nullptr;
+    // Accepts 1e9 as well as 1000000000.
+    double number = strtod(value, &end);
+    result = (long long)number;
+    return end != value && *end == '\0' && result >= 1
+           && number == (double)result;
+}
+
+bool ParseSuite(const char* value, BenchOptions& options){
+    if(strcmp(value, "all") == 0){
+        options.micro = true;
+        options.macro = true;
+    }
+    else if(strcmp(value, "micro") == 0){
+        options.micro = true;
+        options.macro = false;
+    }
+    else if(strcmp(value, "macro") == 0){
+        options.micro = false;
+        options.macro = true;
+    }
+    else
+        return false;
+    return true;
+}
+
+}
+
+bool ParseBenchOptions(int argc, char** argv, BenchOptions& options){
+    for(int i = 1; i < argc; i++){
+        const char* name = argv[i];
+        if(strcmp(name, "--help") == 0 || strcmp(name, "-h") == 0){
+            PrintBenchUsage(argv[0]);
+            return false;
+        }
+        if(i + 1 >= argc){
+            fprintf(stderr, "Missing value for %s\n", name);
+            PrintBenchUsage(argv[0]);
+            return false;
+        }
+        const char* value = argv[++i];
+
+        bool valid = true;
+        if(strcmp(name, "--suite") == 0)
+            valid = ParseSuite(value, options);
+        else if(strcmp(name, "--filter") == 0)
+            options.filter = value;
+        else if(strcmp(name, "--min-time") == 0)
+            valid = ParseDouble(value, options.min_time);
+        else if(strcmp(name, "--steps") == 0)
+            valid = ParseLong(value, options.steps);
+        else if(strcmp(name, "--output") == 0)
+            options.output_path = value;
+        else{
+            fprintf(stderr, "Unknown option %s\n", name);
+            PrintBenchUsage(argv[0]);
+            return false;
+        }
+
+        if(!valid){
+            fprintf(stderr, "Invalid value for %s: %s\n", name, value);
+            return false;
+        }
+    }
+    return true;
+}
+
+void PrintBenchUsage(const char* program){
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --suite SUITE            all (default), micro or macro\n"
+            "  --filter TEXT            run benchmarks whose name "
+            "contains TEXT\n"
+            "  --min-time SECONDS       minimal duration of a "
+            "micro-benchmark (default: 0.5)\n"
+            "  --steps N                steps of a macro-benchmark, "
+            "e.g. 1e6 to 1e9 (default: 1e6)\n"
+            "  --output PATH            JSON output file "
+            "(default: stdout)\n",
+            program);
+}
@@ -0,0 +1,65 @@
+#include "benchmarks.h"
+
+#include <kinematics/hodograph_kinematics.h>
+#include <kinematics/hodograph_ensemble.h>
+
+#include <memory>
+
+namespace {
+
+const float TIME_DELTA = 0.001f;
+const float ERROR = 0.01f;
+const std::size_t ENSEMBLE_SIZE = 1024;
+
+/**
+ * The GUI configuration: default sized cache, one sample per step.
+ */
+BenchmarkBody SustainedKinematics(DerivativeMethod derivative_method){
+    std::shared_ptr<HodographKinematics> kinematics(new HodographKinematics());
+    *kinematics->error() = ERROR;
+    kinematics->derivative_method(derivative_method);
+    return [kinematics](long long iterations){
+        for(long long i = 0; i < iterations; i++)
+            kinematics->Update(TIME_DELTA);
+        DoNotOptimize(kinematics->sample());
+    };
+}
+
+/**
+ * One iteration advances all members, statistics are not computed.
+ */
+BenchmarkBody SustainedEnsemble(){
+    std::shared_ptr<HodographEnsemble> ensemble(
+            new HodographEnsemble(ENSEMBLE_SIZE));
+    HodographParameters parameters;
+    parameters.error = ERROR;
+    ensemble->parameters(parameters);
+    return [ensemble](long long iterations){
+        for(long long i = 0; i < iterations; i++)
+            ensemble->Update(TIME_DELTA);
+        DoNotOptimize(ensemble->positions()[0]);
+    };
+}
+
+void Add(std::vector<Benchmark>& benchmarks, const char* name,
+         BenchmarkSetup setup, long long operations_per_step = 1){
+    Benchmark benchmark;
+    benchmark.name = name;
+    benchmark.suite = BenchmarkSuite::MACRO;
+    benchmark.setup = setup;
+    benchmark.operations_per_step = operations_per_step;
+    benchmarks.push_back(benchmark);
+}
+
+}
+
+void AddMacroBenchmarks(std::vector<Benchmark>& benchmarks){
+    Add(benchmarks, "sustained/kinematics/finite", [](){
+        return SustainedKinematics(DerivativeMethod::FINITE_DIFFERENCE);
+    });
+    Add(benchmarks, "sustained/kinematics/analytic", [](){
+        return SustainedKinematics(DerivativeMethod::ANALYTIC);
+    });
+    Add(benchmarks, "sustained/ensemble_1024", SustainedEnsemble,
+        ENSEMBLE_SIZE);
+}
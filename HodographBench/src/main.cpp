@@ -0,0 +1,47 @@
+#include <bench_options.h>
+#include <benchmarks.h>
+
+#include <cstdio>
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if(!ParseBenchOptions(argc, argv, options))
+        return 1;
+
+#if !defined(__OPTIMIZE__)
+    fprintf(stderr, "Warning: unoptimized build, "
+            "configure with -DCMAKE_BUILD_TYPE=Release\n");
+#endif
+
+    std::vector<Benchmark> benchmarks;
+    if(options.micro)
+        AddMicroBenchmarks(benchmarks);
+    if(options.macro)
+        AddMacroBenchmarks(benchmarks);
+
+    std::vector<BenchmarkResult> results;
+    for(std::size_t i = 0; i < benchmarks.size(); i++){
+        const Benchmark& benchmark = benchmarks[i];
+        if(benchmark.name.find(options.filter) == std::string::npos)
+            continue;
+
+        fprintf(stderr, "%s\n", benchmark.name.c_str());
+        if(benchmark.suite == BenchmarkSuite::MICRO)
+            results.push_back(RunMicroBenchmark(benchmark, options.min_time));
+        else
+            results.push_back(RunMacroBenchmark(benchmark, options.steps));
+    }
+
+    FILE* file = stdout;
+    if(!options.output_path.empty()){
+        file = fopen(options.output_path.c_str(), "w");
+        if(!file){
+            perror(options.output_path.c_str());
+            return 1;
+        }
+    }
+    WriteBenchmarkJson(file, results);
+    if(file != stdout)
+        fclose(file);
+    return 0;
+}
@@ -0,0 +1,547 @@
+#include "benchmarks.h"
+
+#include <kinematics/hodograph_kinematics.h>
+#include <kinematics/crank_slider_kernel.h>
+#include <filters/derivative_filter.h>
+#include <history/compressed_history.h>
+#include <linkage/linkage_mechanism.h>
+#include <noise/noise_stream.h>
+#include <profiling/profiler.h>
+#include <spectrum/spectrum_analyzer.h>
+#include <statistics/phase_density.h>
+#include <telemetry/telemetry_publisher.h>
+
+#include <cmath>
+#include <memory>
+
+namespace {
+
+const float TIME_DELTA = 0.001f;
+const float ERROR = 0.01f;
+const std::size_t NOISE_BLOCK = 1024;
+const std::size_t STEP_BLOCK = 1024;
+const int RESAMPLE_WIDTH = 512;
+// 1000 s of simulated time, long enough for the crank angle to drift.
+const long long ACCURACY_STEPS = 1000000;
+
+std::shared_ptr<HodographKinematics> CreateKinematics(
+        std::size_t cache_capacity, bool cache_enabled,
+        DerivativeMethod derivative_method){
+    std::shared_ptr<HodographKinematics> kinematics(
+            new HodographKinematics(cache_capacity));
+    *kinematics->error() = ERROR;
+    kinematics->cache_enabled(cache_enabled);
+    kinematics->derivative_method(derivative_method);
+    return kinematics;
+}
+
+/**
+ * Kinematics with a full default sized cache, the state of the graphs
+ * after the simulation ran for a while.
+ */
+std::shared_ptr<HodographKinematics> CreateFilledKinematics(){
+    std::shared_ptr<HodographKinematics> kinematics = CreateKinematics(
+            HodographCache::DEFAULT_CAPACITY, true,
+            DerivativeMethod::FINITE_DIFFERENCE);
+    for(std::size_t i = 0; i < HodographCache::DEFAULT_CAPACITY; i++)
+        kinematics->Update(TIME_DELTA);
+    return kinematics;
+}
+
+BenchmarkBody NoiseNext(){
+    std::shared_ptr<NoiseStream> noise_stream(new NoiseStream(1, 0));
+    return [noise_stream](long long iterations){
+        for(long long i = 0; i < iterations; i++)
+            DoNotOptimize(noise_stream->Next());
+    };
+}
+
+BenchmarkBody NoiseFill(){
+    std::shared_ptr<NoiseStream> noise_stream(new NoiseStream(1, 0));
+    std::shared_ptr<std::vector<float>> normals(
+            new std::vector<float>(NOISE_BLOCK));
+    return [noise_stream, normals](long long iterations){
+        for(long long i = 0; i < iterations; i++){
+            noise_stream->Fill(normals->data(), normals->size());
+            DoNotOptimize(normals->front());
+        }
+    };
+}
+
+BenchmarkBody KinematicsUpdate(bool cache_enabled,
+                               DerivativeMethod derivative_method){
+    std::shared_ptr<HodographKinematics> kinematics = CreateKinematics(
+            HodographCache::DEFAULT_CAPACITY, cache_enabled,
+            derivative_method);
+    return [kinematics](long long iterations){
+        for(long long i = 0; i < iterations; i++){
+            kinematics->Update(TIME_DELTA);
+            DoNotOptimize(kinematics->sample());
+        }
+    };
+}
+
+/**
+ * UpdateCache on its own, replays one crank revolution of samples.
+ */
+BenchmarkBody KinematicsSensitivity(DerivativeMethod derivative_method){
+    std::shared_ptr<HodographKinematics> kinematics = CreateKinematics(
+            HodographCache::DEFAULT_CAPACITY, false, derivative_method);
+    kinematics->sensitivity_enabled(true);
+    return [kinematics](long long iterations){
+        for(long long i = 0; i < iterations; i++){
+            kinematics->Update(TIME_DELTA);
+            DoNotOptimize(kinematics->sensitivity());
+        }
+    };
+}
+
+BenchmarkBody KinematicsStep(DerivativeMethod derivative_method){
+    std::shared_ptr<HodographKinematics> kinematics = CreateKinematics(
+            HodographCache::DEFAULT_CAPACITY, false, derivative_method);
+    std::shared_ptr<std::vector<HodographSample>> samples(
+            new std::vector<HodographSample>(STEP_BLOCK));
+    return [kinematics, samples](long long iterations){
+        for(long long i = 0; i < iterations; i++){
+            kinematics->Step(samples->size(), TIME_DELTA, samples->data());
+            DoNotOptimize(samples->back());
+        }
+    };
+}
+
+BenchmarkBody CachePush(){
+    std::shared_ptr<HodographKinematics> kinematics = CreateFilledKinematics();
+    std::shared_ptr<HodographCache> cache(new HodographCache(
+            HodographCache::DEFAULT_CAPACITY));
+    return [kinematics, cache](long long iterations){
+        const HodographCache& source = kinematics->hodograph_cache();
+        std::size_t size = source.size();
+        for(long long i = 0; i < iterations; i++)
+            cache->Push(source.GetSample((std::size_t)i % size));
+        DoNotOptimize(cache->size());
+    };
+}
+
+/**
+ * Data of one history plot, as RenderHistoryPlot requests it.
+ */
+BenchmarkBody GraphResample(){
+    std::shared_ptr<HodographKinematics> kinematics = CreateFilledKinematics();
+    std::shared_ptr<std::vector<MinMax>> columns(
+            new std::vector<MinMax>(RESAMPLE_WIDTH));
+    return [kinematics, columns](long long iterations){
+        const HodographCache& cache = kinematics->hodograph_cache();
+        for(long long i = 0; i < iterations; i++){
+            MinMax range = cache.Resample(HodographChannel::POSITION, Axis::Z,
+                                          0, cache.size(), columns->data(),
+                                          RESAMPLE_WIDTH);
+            DoNotOptimize(range);
+        }
+    };
+}
+
+BenchmarkBody GraphRange(){
+    std::shared_ptr<HodographKinematics> kinematics = CreateFilledKinematics();
+    return [kinematics](long long iterations){
+        const HodographCache& cache = kinematics->hodograph_cache();
+        for(long long i = 0; i < iterations; i++){
+            MinMax range = cache.Range(HodographChannel::VELOCITY, Axis::Z,
+                                       (std::size_t)i % 64, cache.size());
+            DoNotOptimize(range);
+        }
+    };
+}
+
+/**
+ * Per sample cost of the phase portrait, replays one crank revolution.
+ */
+BenchmarkBody PhaseDensityPush(){
+    std::shared_ptr<HodographKinematics> kinematics = CreateFilledKinematics();
+    std::shared_ptr<PhaseDensity> density(new PhaseDensity());
+    return [kinematics, density](long long iterations){
+        const HodographCache& cache = kinematics->hodograph_cache();
+        std::size_t size = cache.size();
+        for(long long i = 0; i < iterations; i++){
+            std::size_t index = (std::size_t)i % size;
+            density->Push(
+                    cache.Get(HodographChannel::POSITION, Axis::Z, index),
+                    cache.Get(HodographChannel::VELOCITY, Axis::Z, index));
+        }
+        DoNotOptimize(density->max_count());
+    };
+}
+
+/**
+ * Per frame work of RenderPhaseonGraphs: one intensity per non-empty
+ * cell, independent of how many samples were pushed.
+ */
+BenchmarkBody PhaseDensityCells(){
+    std::shared_ptr<HodographKinematics> kinematics = CreateFilledKinematics();
+    std::shared_ptr<PhaseDensity> density(new PhaseDensity());
+    const HodographCache& cache = kinematics->hodograph_cache();
+    for(std::size_t i = 0; i < cache.size(); i++){
+        density->Push(cache.Get(HodographChannel::POSITION, Axis::Z, i),
+                      cache.Get(HodographChannel::VELOCITY, Axis::Z, i));
+    }
+    std::shared_ptr<std::vector<float>> intensities(
+            new std::vector<float>(density->cells().size()));
+    return [kinematics, density, intensities](long long iterations){
+        const std::vector<float>& cells = density->cells();
+        float log_max = std::log(1.0f + density->max_count());
+        for(long long n = 0; n < iterations; n++){
+            int visible = 0;
+            for(std::size_t i = 0; i < cells.size(); i++){
+                if(cells[i] <= 0)
+                    continue;
+                (*intensities)[visible++] = std::log(1.0f + cells[i])
+                                            / log_max;
+            }
+            DoNotOptimize(visible);
+        }
+    };
+}
+
+/**
+ * Draw runs of a grid with every cell filled and neighbouring counts
+ * drawn at random, the worst case for merging cells of equal intensity.
+ */
+BenchmarkBody PhaseDensityRunsFull(){
+    std::shared_ptr<PhaseDensity> density(new PhaseDensity());
+    int width = density->width();
+    int height = density->height();
+    NoiseStream noise_stream(1, 0);
+    for(int row = 0; row < height; row++){
+        for(int column = 0; column < width; column++){
+            int count = 1 + (int)(4 * std::fabs(noise_stream.Next()));
+            for(int i = 0; i < count; i++)
+                density->Push(column + 0.5f, row + 0.5f);
+        }
+    }
+    std::shared_ptr<std::vector<DensityRun>> runs(
+            new std::vector<DensityRun>());
+    return [density, runs](long long iterations){
+        for(long long n = 0; n < iterations; n++){
+            density->Runs(PhaseDensity::DEFAULT_LEVELS,
+                          PhaseDensity::DEFAULT_MAX_RUNS, *runs);
+            DoNotOptimize(runs->size());
+        }
+    };
+}
+
+/**
+ * Per sample cost of tracking the harmonics of all three channels.
+ */
+BenchmarkBody SpectrumPush(){
+    std::shared_ptr<HodographKinematics> kinematics = CreateFilledKinematics();
+    std::shared_ptr<SpectrumAnalyzer> spectrum(new SpectrumAnalyzer());
+    spectrum->Configure(*kinematics->angular_velocity(), TIME_DELTA,
+                        SpectrumAnalyzer::DEFAULT_HARMONICS);
+    return [kinematics, spectrum](long long iterations){
+        const HodographCache& cache = kinematics->hodograph_cache();
+        std::size_t size = cache.size();
+        for(long long i = 0; i < iterations; i++)
+            spectrum->Push(cache.GetSample((std::size_t)i % size));
+        DoNotOptimize(spectrum->dft(HodographChannel::POSITION));
+    };
+}
+
+BenchmarkBody SpectrumFft(){
+    std::shared_ptr<HodographKinematics> kinematics = CreateFilledKinematics();
+    std::shared_ptr<SpectrumAnalyzer> spectrum(new SpectrumAnalyzer());
+    spectrum->Configure(*kinematics->angular_velocity(), TIME_DELTA,
+                        SpectrumAnalyzer::DEFAULT_HARMONICS);
+    return [kinematics, spectrum](long long iterations){
+        for(long long i = 0; i < iterations; i++)
+            spectrum->UpdateFft(kinematics->hodograph_cache(), 4096);
+        DoNotOptimize(spectrum->fft(HodographChannel::POSITION));
+    };
+}
+
+/**
+ * The history owns a cache line aligned queue, which C++11 operator new
+ * does not align. Benchmarks share one instance instead.
+ */
+CompressedHistory* ClearedHistory(){
+    static CompressedHistory history;
+    history.Clear();
+    return &history;
+}
+
+/**
+ * Owner side cost of the compressed history, replays one crank revolution.
+ * Compression runs on the history's thread, on one core it is included.
+ */
+BenchmarkBody HistoryPush(){
+    std::shared_ptr<HodographKinematics> kinematics = CreateFilledKinematics();
+    CompressedHistory* history = ClearedHistory();
+    return [kinematics, history](long long iterations){
+        const HodographCache& cache = kinematics->hodograph_cache();
+        std::size_t size = cache.size();
+        for(long long i = 0; i < iterations; i++)
+            history->Push(cache.GetSample((std::size_t)i % size));
+        DoNotOptimize(history->size());
+    };
+}
+
+/**
+ * Decodes one compressed chunk of the slider velocity.
+ */
+BenchmarkBody HistoryDecode(){
+    std::shared_ptr<HodographKinematics> kinematics = CreateFilledKinematics();
+    CompressedHistory* history = ClearedHistory();
+    const HodographCache& cache = kinematics->hodograph_cache();
+    for(std::size_t i = 0; i < 2 * CompressedHistory::CHUNK_SIZE; i++)
+        history->Push(cache.GetSample(i % cache.size()));
+    history->Flush();
+
+    std::shared_ptr<std::vector<float>> values(
+            new std::vector<float>(CompressedHistory::CHUNK_SIZE));
+    return [history, values](long long iterations){
+        for(long long i = 0; i < iterations; i++){
+            // Alternating chunks defeats the single chunk decode cache.
+            std::size_t begin = (i % 2) * CompressedHistory::CHUNK_SIZE;
+            history->Read(HodographChannel::VELOCITY, Axis::Z, begin,
+                          begin + CompressedHistory::CHUNK_SIZE,
+                          values->data());
+            DoNotOptimize(values->front());
+        }
+    };
+}
+
+BenchmarkBody TelemetryPublish(){
+    std::shared_ptr<TelemetryPublisher> publisher(new TelemetryPublisher());
+    publisher->Open("/hodograph_bench");
+    std::shared_ptr<HodographKinematics> kinematics = CreateFilledKinematics();
+    TraceRecord record = CreateTraceRecord(
+            kinematics->time(), kinematics->alpha(),
+            kinematics->line_error_length(), kinematics->line().position0,
+            kinematics->sample());
+    return [publisher, record](long long iterations){
+        for(long long i = 0; i < iterations; i++)
+            publisher->Publish(record);
+        DoNotOptimize(publisher->published());
+    };
+}
+
+/**
+ * Per sample cost of the derivative filter, replays one crank revolution
+ * of positions.
+ */
+BenchmarkBody FilterPush(FilterType type){
+    std::shared_ptr<HodographKinematics> kinematics = CreateFilledKinematics();
+    std::shared_ptr<DerivativeFilter> filter(new DerivativeFilter());
+    FilterSettings settings;
+    settings.type = type;
+    filter->Configure(settings, TIME_DELTA);
+    return [kinematics, filter](long long iterations){
+        const HodographCache& cache = kinematics->hodograph_cache();
+        std::size_t size = cache.size();
+        for(long long i = 0; i < iterations; i++){
+            DoNotOptimize(filter->Push(cache.Get(
+                    HodographChannel::POSITION, (std::size_t)i % size)));
+        }
+    };
+}
+
+/**
+ * One warm-started solve of count mechanisms with slightly different
+ * cranks, every iteration advances all of them by one step.
+ */
+BenchmarkBody LinkageSolve(MechanismType type, std::size_t count){
+    std::shared_ptr<std::vector<Mechanism>> mechanisms(
+            new std::vector<Mechanism>());
+    MechanismSettings settings;
+    settings.type = type;
+    settings.offset = 0.5f;
+    for(std::size_t i = 0; i < count; i++){
+        HodographParameters parameters;
+        parameters.radius = 1 + 0.1f * i / count;
+        mechanisms->push_back(CreateMechanism(settings, parameters));
+    }
+    return [mechanisms](long long iterations){
+        double step = 2 * M_PI / 1000;
+        for(long long i = 0; i < iterations; i++){
+            double alpha = std::fmod((i + 1) * step, 2 * M_PI);
+            for(Mechanism& mechanism : *mechanisms)
+                DoNotOptimize(mechanism.linkage.Solve(alpha));
+        }
+    };
+}
+
+/**
+ * Cost of one ProfileScope, the profiler is disabled again afterwards.
+ */
+BenchmarkBody ProfilerScope(bool enabled){
+    return [enabled](long long iterations){
+        Profiler::enabled(enabled);
+        for(long long i = 0; i < iterations; i++){
+            ProfileScope scope("Benchmark");
+            DoNotOptimize(i);
+        }
+        Profiler::enabled(false);
+    };
+}
+
+void Add(std::vector<Benchmark>& benchmarks, const char* name,
+         BenchmarkSetup setup,
+         BenchmarkAccuracy accuracy = BenchmarkAccuracy()){
+    Benchmark benchmark;
+    benchmark.name = name;
+    benchmark.suite = BenchmarkSuite::MICRO;
+    benchmark.setup = setup;
+    benchmark.operations_per_step = 1;
+    benchmark.accuracy = accuracy;
+    benchmarks.push_back(benchmark);
+}
+
+template<typename Scalar, DerivativeMethod Method, bool Noise>
+BenchmarkBody KernelStep(){
+    typedef CrankSliderKernel<Scalar, Method, Noise> Kernel;
+    HodographParameters parameters;
+    parameters.error = ERROR;
+    std::shared_ptr<Kernel> kernel(new Kernel(parameters, TIME_DELTA));
+    std::shared_ptr<NoiseStream> noise_stream(new NoiseStream(1, 0));
+    return [kernel, noise_stream](long long iterations){
+        for(long long i = 0; i < iterations; i++){
+            kernel->Step(*noise_stream);
+            DoNotOptimize(kernel->state());
+        }
+    };
+}
+
+/**
+ * Largest slider position error over ACCURACY_STEPS against long double
+ * math with the crank angle computed from the step index, fed the same
+ * noise.
+ */
+template<typename Scalar, DerivativeMethod Method, bool Noise>
+double KernelAccuracy(){
+    typedef CrankSliderKernel<Scalar, Method, Noise> Kernel;
+    HodographParameters parameters;
+    parameters.error = ERROR;
+    Kernel kernel(parameters, TIME_DELTA);
+    NoiseStream noise_stream(1, 0);
+    NoiseStream reference_noise(1, 0);
+
+    const long double two_pi = 2 * 3.14159265358979323846264338327950288L;
+    long double phase_step = (long double)parameters.angular_velocity
+                             * (long double)TIME_DELTA;
+    long double radius = parameters.radius;
+    double max_error = 0;
+    for(long long step = 0; step < ACCURACY_STEPS; step++){
+        kernel.Step(noise_stream);
+
+        long double line_length = parameters.line_length;
+        if(Noise)
+            line_length += (long double)parameters.error
+                           * reference_noise.Next();
+        long double alpha = fmodl(phase_step * step, two_pi);
+        long double y = radius * cosl(alpha);
+        long double position = radius * sinl(alpha)
+                               + sqrtl(line_length * line_length - y * y);
+
+        double error = (double)fabsl(
+                (long double)kernel.state().position - position);
+        if(error > max_error)
+            max_error = error;
+    }
+    return max_error;
+}
+
+template<typename Scalar, DerivativeMethod Method, bool Noise>
+void AddKernel(std::vector<Benchmark>& benchmarks, const char* name){
+    Add(benchmarks, name, KernelStep<Scalar, Method, Noise>,
+        KernelAccuracy<Scalar, Method, Noise>);
+}
+
+}
+
+void AddMicroBenchmarks(std::vector<Benchmark>& benchmarks){
+    Add(benchmarks, "noise/next", NoiseNext);
+    Add(benchmarks, "noise/fill_1024", NoiseFill);
+
+    // UpdateLine and UpdateSample are private, Update without the cache
+    // measures both, the cached variants add UpdateCache.
+    Add(benchmarks, "kinematics/update_line/finite", [](){
+        return KinematicsUpdate(false, DerivativeMethod::FINITE_DIFFERENCE);
+    });
+    Add(benchmarks, "kinematics/update_line/analytic", [](){
+        return KinematicsUpdate(false, DerivativeMethod::ANALYTIC);
+    });
+    Add(benchmarks, "kinematics/update_cached/finite", [](){
+        return KinematicsUpdate(true, DerivativeMethod::FINITE_DIFFERENCE);
+    });
+    Add(benchmarks, "kinematics/sensitivity/finite", [](){
+        return KinematicsSensitivity(DerivativeMethod::FINITE_DIFFERENCE);
+    });
+    Add(benchmarks, "kinematics/sensitivity/analytic", [](){
+        return KinematicsSensitivity(DerivativeMethod::ANALYTIC);
+    });
+    Add(benchmarks, "kinematics/step_1024/finite", [](){
+        return KinematicsStep(DerivativeMethod::FINITE_DIFFERENCE);
+    });
+    Add(benchmarks, "kinematics/step_1024/analytic", [](){
+        return KinematicsStep(DerivativeMethod::ANALYTIC);
+    });
+    Add(benchmarks, "cache/push", CachePush);
+
+    // Every precision and compile time option of the slider kernel,
+    // max_error is the slider position error after ACCURACY_STEPS.
+    AddKernel<float, DerivativeMethod::FINITE_DIFFERENCE, false>(
+            benchmarks, "kernel/float/finite/exact");
+    AddKernel<float, DerivativeMethod::FINITE_DIFFERENCE, true>(
+            benchmarks, "kernel/float/finite/noise");
+    AddKernel<float, DerivativeMethod::ANALYTIC, false>(
+            benchmarks, "kernel/float/analytic/exact");
+    AddKernel<float, DerivativeMethod::ANALYTIC, true>(
+            benchmarks, "kernel/float/analytic/noise");
+    AddKernel<double, DerivativeMethod::FINITE_DIFFERENCE, false>(
+            benchmarks, "kernel/double/finite/exact");
+    AddKernel<double, DerivativeMethod::FINITE_DIFFERENCE, true>(
+            benchmarks, "kernel/double/finite/noise");
+    AddKernel<double, DerivativeMethod::ANALYTIC, false>(
+            benchmarks, "kernel/double/analytic/exact");
+    AddKernel<double, DerivativeMethod::ANALYTIC, true>(
+            benchmarks, "kernel/double/analytic/noise");
+
+    Add(benchmarks, "graph/resample_512", GraphResample);
+    Add(benchmarks, "graph/range", GraphRange);
+    Add(benchmarks, "graph/phase_density/push", PhaseDensityPush);
+    Add(benchmarks, "graph/phase_density/cells", PhaseDensityCells);
+    Add(benchmarks, "graph/phase_density/runs_full", PhaseDensityRunsFull);
+
+    Add(benchmarks, "spectrum/push", SpectrumPush);
+    Add(benchmarks, "spectrum/fft_4096", SpectrumFft);
+
+    Add(benchmarks, "history/push", HistoryPush);
+    Add(benchmarks, "history/decode_4096", HistoryDecode);
+
+    Add(benchmarks, "telemetry/publish", TelemetryPublish);
+
+    Add(benchmarks, "linkage/solve/offset_slider_crank", [](){
+        return LinkageSolve(MechanismType::OFFSET_SLIDER_CRANK, 1);
+    });
+    Add(benchmarks, "linkage/solve/four_bar", [](){
+        return LinkageSolve(MechanismType::FOUR_BAR, 1);
+    });
+    Add(benchmarks, "linkage/solve/two_loop", [](){
+        return LinkageSolve(MechanismType::TWO_LOOP, 1);
+    });
+    Add(benchmarks, "linkage/solve_1024/four_bar", [](){
+        return LinkageSolve(MechanismType::FOUR_BAR, 1024);
+    });
+
+    Add(benchmarks, "filter/push/savitzky_golay", [](){
+        return FilterPush(FilterType::SAVITZKY_GOLAY);
+    });
+    Add(benchmarks, "filter/push/exponential", [](){
+        return FilterPush(FilterType::EXPONENTIAL);
+    });
+
+    Add(benchmarks, "profiler/scope_disabled", [](){
+        return ProfilerScope(false);
+    });
+    Add(benchmarks, "profiler/scope_enabled", [](){
+        return ProfilerScope(true);
+    });
+}
@@ -0,0 +1,58 @@
+#include <memory/allocation_counter.h>
+
+#include <cstdlib>
+#include <new>
+
+/**
+ * Global operator new and delete that feed AllocationCounter. Not part of
+ * hodograph_core, a binary opts in by adding the
+ * hodograph_allocation_hooks objects to its sources.
+ */
+
+namespace {
+
+void* Allocate(std::size_t size){
+    AllocationCounter::Record(size);
+    return malloc(size == 0 ? 1 : size);
+}
+
+struct EnableCounter{
+    EnableCounter(){AllocationCounter::Enable();}
+} enable_counter;
+
+}
+
+void* operator new(std::size_t size){
+    void* pointer = Allocate(size);
+    if(!pointer)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept{
+    return Allocate(size);
+}
+
+void* operator new[](std::size_t size){
+    return operator new(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept{
+    return Allocate(size);
+}
+
+void operator delete(void* pointer) noexcept{
+    free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept{
+    free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept{
+    free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept{
+    free(pointer);
+}
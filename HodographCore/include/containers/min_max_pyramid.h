@@ -0,0 +1,59 @@
+#ifndef PROJECT_MIN_MAX_PYRAMID_H
+#define PROJECT_MIN_MAX_PYRAMID_H
+
+#include <containers/ring_buffer.h>
+
+#include <cstddef>
+#include <vector>
+
+struct MinMax{
+    float min;
+    float max;
+};
+
+/**
+ * Min/max summaries of a bounded history for fast plotting.
+ *
+ * Level k holds the min/max of aligned blocks of 2^k samples, the raw
+ * samples (level 0) stay in the caller's RingView. Push updates one block
+ * per level, any range query is covered by O(log n) blocks.
+ */
+class MinMaxPyramid{
+public:
+    MinMaxPyramid(std::size_t capacity = 0);
+    ~MinMaxPyramid();
+
+    std::size_t size() const {
+        return count_ < capacity_ ? (std::size_t)count_ : capacity_;}
+    std::size_t capacity() const {return capacity_;}
+
+    void SetCapacity(std::size_t capacity);
+    void Clear();
+
+    void Push(float value);
+
+    /**
+     * Min/max of the samples [begin, end) of the retained history,
+     * index 0 is the oldest sample. raw must be the view of the same
+     * history the pyramid was fed with.
+     */
+    MinMax Range(const RingView<float>& raw,
+                 std::size_t begin, std::size_t end) const;
+
+    /**
+     * Splits [begin, end) into width equal columns and writes the min/max
+     * of each. Returns the min/max of the whole range.
+     */
+    MinMax Resample(const RingView<float>& raw,
+                    std::size_t begin, std::size_t end,
+                    MinMax* columns, int width) const;
+
+    std::size_t memory_bytes() const;
+
+private:
+    std::vector<std::vector<MinMax>> levels_;
+    std::size_t capacity_;
+    unsigned long long count_;
+};
+
+#endif //PROJECT_MIN_MAX_PYRAMID_H
@@ -0,0 +1,100 @@
+#ifndef PROJECT_RING_BUFFER_H
+#define PROJECT_RING_BUFFER_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Contiguous view over a ring buffer.
+ * Element i lives at data[(offset + i) % size], which is exactly the layout
+ * ImGui::PlotLines expects through its values_offset parameter.
+ */
+template<typename T>
+struct RingView{
+    const T* data;
+    int size;
+    int offset;
+
+    const T& operator[](int i) const {
+        int index = offset + i;
+        if(index >= size)
+            index -= size;
+        return data[index];
+    }
+};
+
+/**
+ * Fixed capacity history. Storage is allocated once in SetCapacity,
+ * Push never allocates and overwrites the oldest element when full.
+ */
+template<typename T>
+class RingBuffer{
+public:
+    RingBuffer(std::size_t capacity) :
+            head_(0), size_(0){
+        SetCapacity(capacity);
+    }
+    ~RingBuffer(){}
+
+    std::size_t size() const {return size_;}
+    std::size_t capacity() const {return data_.size();}
+    bool full() const {return size_ == data_.size();}
+    bool empty() const {return size_ == 0;}
+
+    const T* data() const {return data_.data();}
+
+    /**
+     * Index of the oldest element in data().
+     */
+    std::size_t offset() const {return full() ? head_ : 0;}
+
+    RingView<T> view() const {
+        RingView<T> view;
+        view.data = data_.data();
+        view.size = (int)size_;
+        view.offset = (int)offset();
+        return view;
+    }
+
+    const T& operator[](std::size_t i) const {
+        std::size_t index = offset() + i;
+        if(index >= data_.size())
+            index -= data_.size();
+        return data_[index];
+    }
+
+    const T& back() const {
+        return data_[head_ == 0 ? data_.size() - 1 : head_ - 1];
+    }
+
+    void Push(const T& value){
+        data_[head_] = value;
+        if(++head_ == data_.size())
+            head_ = 0;
+        if(size_ < data_.size())
+            size_++;
+    }
+
+    void Clear(){
+        head_ = 0;
+        size_ = 0;
+    }
+
+    /**
+     * Reallocates the storage, drops the current history.
+     */
+    void SetCapacity(std::size_t capacity){
+        if(capacity == 0)
+            capacity = 1;
+        data_.assign(capacity, T());
+        data_.shrink_to_fit();
+        Clear();
+    }
+
+private:
+    std::vector<T> data_;
+    std::size_t head_;
+    std::size_t size_;
+};
+
+#endif //PROJECT_RING_BUFFER_H
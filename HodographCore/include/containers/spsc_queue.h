@@ -0,0 +1,70 @@
+#ifndef PROJECT_SPSC_QUEUE_H
+#define PROJECT_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Bounded lock-free queue for exactly one producer thread and one
+ * consumer thread. Capacity is rounded up to a power of two, storage is
+ * allocated once in the constructor.
+ */
+template<typename T>
+class SpscQueue{
+public:
+    SpscQueue(std::size_t capacity) :
+            head_(0), tail_(0){
+        std::size_t size = 1;
+        while(size < capacity)
+            size <<= 1;
+        data_.resize(size);
+        mask_ = size - 1;
+    }
+    ~SpscQueue(){}
+
+    std::size_t capacity() const {return data_.size();}
+
+    /**
+     * Producer side. Returns false when the queue is full.
+     */
+    bool TryPush(const T& value){
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if(tail - head_.load(std::memory_order_acquire) == data_.size())
+            return false;
+        data_[tail & mask_] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Consumer side. Returns false when the queue is empty.
+     */
+    bool TryPop(T& value){
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if(head == tail_.load(std::memory_order_acquire))
+            return false;
+        value = data_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Approximate when called concurrently with the other side.
+     */
+    std::size_t size() const {
+        return tail_.load(std::memory_order_acquire)
+               - head_.load(std::memory_order_acquire);
+    }
+
+private:
+    static const std::size_t CACHE_LINE = 64;
+
+    std::vector<T> data_;
+    std::size_t mask_;
+
+    alignas(CACHE_LINE) std::atomic<std::size_t> head_;
+    alignas(CACHE_LINE) std::atomic<std::size_t> tail_;
+};
+
+#endif //PROJECT_SPSC_QUEUE_H
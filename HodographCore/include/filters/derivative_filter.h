@@ -0,0 +1,111 @@
+#ifndef PROJECT_DERIVATIVE_FILTER_H
+#define PROJECT_DERIVATIVE_FILTER_H
+
+#include <filters/fir_bank.h>
+#include <kinematics/hodograph_cache.h>
+
+#include <vector>
+
+enum class FilterType{
+    NONE, SAVITZKY_GOLAY, MOVING_AVERAGE, EXPONENTIAL
+};
+
+struct FilterSettings{
+    static const int MAX_HALF_WINDOW = 64;
+    /**
+     * Highest Savitzky-Golay order, beyond it the float kernels amplify
+     * noise more than they follow the signal.
+     */
+    static const int MAX_ORDER = 12;
+
+    /**
+     * Highest order a window of 2 * half_window + 1 samples can fit.
+     */
+    static int MaxOrder(int half_window){
+        return half_window * 2 < MAX_ORDER ? half_window * 2 : MAX_ORDER;
+    }
+
+    FilterType type = FilterType::NONE;
+    /**
+     * FIR filters average 2 * half_window + 1 samples, at most
+     * MAX_HALF_WINDOW.
+     */
+    int half_window = 8;
+    /**
+     * Savitzky-Golay polynomial order, 2 .. MaxOrder(half_window).
+     */
+    int order = 2;
+    /**
+     * Exponential smoothing factor in (0, 1], 1 keeps the raw positions.
+     */
+    float smoothing = 0.2f;
+};
+
+inline bool operator==(const FilterSettings& a, const FilterSettings& b){
+    return a.type == b.type && a.half_window == b.half_window
+           && a.order == b.order && a.smoothing == b.smoothing;
+}
+
+inline bool operator!=(const FilterSettings& a, const FilterSettings& b){
+    return !(a == b);
+}
+
+/**
+ * Samples the filtered output lags behind its input, exact for the
+ * linear phase FIR filters, the low frequency limit for EXPONENTIAL.
+ */
+float FilterGroupDelay(const FilterSettings& settings);
+
+/**
+ * Convolution coefficients of a Savitzky-Golay filter: the derivative-th
+ * derivative at the window center of the least squares polynomial fit
+ * over t = -half_window .. half_window, unit sample spacing.
+ * coefficients[i] multiplies the sample at t = i - half_window.
+ */
+std::vector<double> SavitzkyGolayCoefficients(int half_window, int order,
+                                              int derivative);
+
+/**
+ * Streaming position, velocity and acceleration estimates from noisy
+ * positions.
+ *
+ * SAVITZKY_GOLAY and MOVING_AVERAGE are FIR banks, one kernel per
+ * derivative. EXPONENTIAL smooths the positions with a first order IIR
+ * before central differences. The output describes the input
+ * FilterGroupDelay() samples ago.
+ */
+class DerivativeFilter{
+public:
+    DerivativeFilter();
+    ~DerivativeFilter();
+
+    /**
+     * Rebuilds the kernels when settings or time_delta changed.
+     */
+    void Configure(const FilterSettings& settings, float time_delta);
+
+    const FilterSettings& settings() const {return settings_;}
+    bool enabled() const {return settings_.type != FilterType::NONE;}
+
+    HodographSample Push(const Vec3& position);
+    void Clear();
+
+    /**
+     * False while the kernels still reach back into the history seeded
+     * with the first position, the first taps - 1 outputs after Clear.
+     * EXPONENTIAL also waits until its start transient decayed to 0.1%.
+     */
+    bool settled() const {return pushed_ > warm_up_;}
+
+private:
+    FirBank banks_[3];
+    Vec3 smoothed_;
+    bool primed_;
+    std::size_t warm_up_;
+    std::size_t pushed_;
+
+    FilterSettings settings_;
+    float time_delta_;
+};
+
+#endif //PROJECT_DERIVATIVE_FILTER_H
@@ -0,0 +1,51 @@
+#ifndef PROJECT_FIR_BANK_H
+#define PROJECT_FIR_BANK_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Convolves one sample stream with several kernels of equal length.
+ *
+ * The history is stored twice in a row, so the newest length() samples
+ * are always contiguous and each output is a plain dot product. Push
+ * costs kernel_count() * length() multiply-adds and never allocates.
+ */
+class FirBank{
+public:
+    FirBank();
+    ~FirBank();
+
+    /**
+     * kernels[k][j] multiplies the sample j steps in the past.
+     * All kernels must have the same length.
+     */
+    void SetKernels(const std::vector<std::vector<float>>& kernels);
+
+    /**
+     * Kernel length rounded up to a multiple of 4.
+     */
+    std::size_t length() const {return length_;}
+    std::size_t kernel_count() const {return kernel_count_;}
+
+    /**
+     * Writes one output per kernel. The first sample after Clear fills
+     * the whole history, so a constant input starts in steady state.
+     */
+    void Push(float x, float* outputs);
+    void Clear();
+
+private:
+    /**
+     * Kernels reversed to match the history order, oldest sample first.
+     */
+    std::vector<float> kernels_;
+    std::vector<float> history_;
+
+    std::size_t length_;
+    std::size_t kernel_count_;
+    std::size_t head_;
+    bool primed_;
+};
+
+#endif //PROJECT_FIR_BANK_H
@@ -0,0 +1,114 @@
+#ifndef PROJECT_COMPRESSED_HISTORY_H
+#define PROJECT_COMPRESSED_HISTORY_H
+
+#include <kinematics/hodograph_cache.h>
+#include <containers/spsc_queue.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+const int HISTORY_COLUMN_COUNT = HODOGRAPH_CHANNEL_COUNT * AXIS_COUNT;
+
+/**
+ * CHUNK_SIZE samples of every (channel, axis) column. Sealed chunks are
+ * compressed by the background thread, which publishes the words through
+ * compressed. The owner frees the raw columns once it sees the flag.
+ */
+struct HistoryChunk{
+    HistoryChunk() : size(0), compressed(false){}
+
+    std::size_t size;
+    std::vector<float> raw[HISTORY_COLUMN_COUNT];
+    std::vector<uint64_t> words[HISTORY_COLUMN_COUNT];
+    MinMax ranges[HISTORY_COLUMN_COUNT];
+    std::atomic<bool> compressed;
+};
+
+/**
+ * Lossless history of every sample since the last Clear, unlike
+ * HodographCache not bounded by a capacity.
+ *
+ * Samples are collected into chunks of CHUNK_SIZE. A full chunk is handed
+ * to a background thread that encodes each column with EncodeFloats, so
+ * a sample stays uncompressed for at most one chunk plus one polling
+ * period. Smooth periodic columns take a few bits per sample, constant
+ * ones almost nothing.
+ *
+ * Push, Read, Resample and Clear are called from a single owner thread.
+ */
+class CompressedHistory{
+public:
+    static const std::size_t CHUNK_SIZE = 4096;
+    static const std::size_t DEFAULT_QUEUE_CAPACITY = 256;
+
+    CompressedHistory(std::size_t queue_capacity = DEFAULT_QUEUE_CAPACITY);
+    ~CompressedHistory();
+
+    std::size_t size() const {return size_;}
+
+    void Push(const HodographSample& sample);
+    void Clear();
+
+    /**
+     * Waits until every full chunk is compressed and frees its raw
+     * columns.
+     */
+    void Flush();
+
+    /**
+     * Copies samples [begin, end) of one column, 0 is the oldest sample.
+     */
+    void Read(HodographChannel channel, Axis axis,
+              std::size_t begin, std::size_t end, float* values) const;
+
+    /**
+     * Same as HodographCache::Resample. Chunks that lie inside a column
+     * use their stored range and are not decoded.
+     */
+    MinMax Resample(HodographChannel channel, Axis axis,
+                    std::size_t begin, std::size_t end,
+                    MinMax* columns, int width) const;
+
+    /**
+     * Heap memory of all chunks, compressed or not.
+     */
+    std::size_t memory_bytes() const;
+
+    /**
+     * Memory the same samples take in HodographSample form.
+     */
+    std::size_t raw_bytes() const {return size_ * sizeof(HodographSample);}
+
+    std::size_t pending_chunks() const;
+
+private:
+    void Run();
+    void Seal();
+    void ReleaseRaw();
+    void Start();
+    void Stop();
+
+    const float* Decode(std::size_t chunk, int column) const;
+    MinMax Range(int column, std::size_t begin, std::size_t end) const;
+
+    std::vector<std::unique_ptr<HistoryChunk>> chunks_;
+    std::size_t size_;
+    /**
+     * Chunks before this index have been compressed and freed their raw
+     * columns.
+     */
+    std::size_t released_;
+
+    SpscQueue<HistoryChunk*> queue_;
+    std::thread thread_;
+    std::atomic<bool> stop_;
+
+    mutable std::vector<float> decoded_;
+    mutable std::size_t decoded_chunk_;
+    mutable int decoded_column_;
+};
+
+#endif //PROJECT_COMPRESSED_HISTORY_H
@@ -0,0 +1,38 @@
+#ifndef PROJECT_FLOAT_CODEC_H
+#define PROJECT_FLOAT_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Lossless compression of a smooth float series, in the spirit of the
+ * Gorilla and Chimp time series codecs.
+ *
+ * The bit pattern of every value is predicted from the previous three by
+ * quadratic extrapolation, done on the patterns as integers so decoding
+ * is exact. Within one binade the patterns are linear in the value, so
+ * smooth motion leaves residuals of a few units in the last place. The
+ * zig-zag residual is written with a short prefix code. Each call picks
+ * the extrapolation order with the fewest bits, constant series cost 35
+ * bits in total and series without structure are stored raw.
+ *
+ * Finite difference derivatives defeat the extrapolation, their values
+ * jump between a few multiples of ulp / dt. Series with at most 256
+ * distinct values may instead store each value once, in the spirit of
+ * the Chimp128 reference window, and a fixed width index per value.
+ */
+
+/**
+ * Replaces words with the encoded values and one padding word, returns
+ * the number of bits used.
+ */
+std::size_t EncodeFloats(const float* values, std::size_t count,
+                         std::vector<uint64_t>& words);
+
+/**
+ * Decodes count values written by one EncodeFloats call.
+ */
+void DecodeFloats(const uint64_t* words, std::size_t count, float* values);
+
+#endif //PROJECT_FLOAT_CODEC_H
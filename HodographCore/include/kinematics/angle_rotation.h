@@ -0,0 +1,55 @@
+#ifndef PROJECT_ANGLE_ROTATION_H
+#define PROJECT_ANGLE_ROTATION_H
+
+#include <cmath>
+
+/**
+ * sin and cos of an angle advancing by a fixed step, without calling trig
+ * functions per step:
+ *   (s, c) <- (s cos(h) + c sin(h), c cos(h) - s sin(h))
+ *
+ * Rounding makes |(s, c)| drift away from 1, every RENORMALIZE_PERIOD
+ * steps it is pulled back with one Newton step for 1 / |(s, c)|. The
+ * phase error is not corrected, Reset re-anchors the recurrence.
+ */
+class AngleRotation{
+public:
+    static const int RENORMALIZE_PERIOD = 64;
+
+    AngleRotation(double angle, double step) :
+            step_sin_(std::sin(step)),
+            step_cos_(std::cos(step)){
+        Reset(angle);
+    }
+
+    double sin() const {return sin_;}
+    double cos() const {return cos_;}
+
+    void Reset(double angle){
+        sin_ = std::sin(angle);
+        cos_ = std::cos(angle);
+        count_ = 0;
+    }
+
+    void Next(){
+        double s = sin_ * step_cos_ + cos_ * step_sin_;
+        double c = cos_ * step_cos_ - sin_ * step_sin_;
+        if(++count_ == RENORMALIZE_PERIOD){
+            double scale = 1.5 - 0.5 * (s * s + c * c);
+            s *= scale;
+            c *= scale;
+            count_ = 0;
+        }
+        sin_ = s;
+        cos_ = c;
+    }
+
+private:
+    double step_sin_;
+    double step_cos_;
+    double sin_;
+    double cos_;
+    int count_;
+};
+
+#endif //PROJECT_ANGLE_ROTATION_H
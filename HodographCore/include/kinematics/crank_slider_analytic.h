@@ -0,0 +1,28 @@
+#ifndef PROJECT_CRANK_SLIDER_ANALYTIC_H
+#define PROJECT_CRANK_SLIDER_ANALYTIC_H
+
+#include <cstddef>
+
+enum class DerivativeMethod{
+    FINITE_DIFFERENCE, ANALYTIC
+};
+
+/**
+ * Exact slider position and its time derivatives at constant angular
+ * velocity w:
+ *  z(a)   = r sin(a) + s,  s = sqrt(L^2 - r^2 cos^2(a))
+ *  z'(a)  = r cos(a) + r^2 sin(a) cos(a) / s
+ *  z''(a) = -r sin(a) + r^2 cos(2a) / s - (r^2 sin(a) cos(a))^2 / s^3
+ *  v = w z',  a = w^2 z''
+ *
+ * Takes precomputed sin/cos of the crank angle. The loop has no branches
+ * so the compiler can vectorize it.
+ */
+void EvaluateCrankSlider(const float* sin_alpha, const float* cos_alpha,
+                         std::size_t count,
+                         float radius, float line_length,
+                         float angular_velocity,
+                         float* positions, float* velocities,
+                         float* accelerations);
+
+#endif //PROJECT_CRANK_SLIDER_ANALYTIC_H
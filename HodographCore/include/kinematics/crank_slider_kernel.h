@@ -0,0 +1,174 @@
+#ifndef PROJECT_CRANK_SLIDER_KERNEL_H
+#define PROJECT_CRANK_SLIDER_KERNEL_H
+
+#include <kinematics/crank_slider_analytic.h>
+#include <kinematics/hodograph_parameters.h>
+#include <noise/noise_stream.h>
+
+#include <cmath>
+
+/**
+ * sqrt(L^2 - y^2) as sqrt((L - y)(L + y)), which does not cancel when
+ * L and y are close.
+ */
+template<typename Scalar>
+inline Scalar SliderOffset(Scalar line_length, Scalar y){
+    using std::sqrt;
+    return sqrt((line_length - y) * (line_length + y));
+}
+
+/**
+ * Slider position r sin(a) + sqrt(L^2 - r^2 cos^2(a)).
+ */
+template<typename Scalar>
+inline Scalar SliderPosition(Scalar sin_alpha, Scalar cos_alpha,
+                             Scalar radius, Scalar line_length){
+    return radius * sin_alpha + SliderOffset(line_length, radius * cos_alpha);
+}
+
+/**
+ * Single point of EvaluateCrankSlider for any scalar type with
+ * arithmetic operators and sqrt found by argument dependent lookup.
+ */
+template<typename Scalar>
+inline void EvaluateCrankSliderPoint(Scalar sin_alpha, Scalar cos_alpha,
+                                     Scalar radius, Scalar line_length,
+                                     Scalar angular_velocity,
+                                     Scalar& position, Scalar& velocity,
+                                     Scalar& acceleration){
+    const Scalar one = Scalar(1);
+    Scalar s = sin_alpha;
+    Scalar c = cos_alpha;
+    Scalar r_sqr = radius * radius;
+
+    Scalar z0 = radius * s;
+    Scalar root = SliderOffset(line_length, radius * c);
+    Scalar inv_root = one / root;
+
+    Scalar g = r_sqr * s * c;
+    Scalar dz = radius * c + g * inv_root;
+    Scalar ddz = -z0 + r_sqr * (c * c - s * s) * inv_root
+                 - g * g * inv_root * inv_root * inv_root;
+
+    position = z0 + root;
+    velocity = angular_velocity * dz;
+    acceleration = angular_velocity * angular_velocity * ddz;
+}
+
+/**
+ * Slider state of one step, see CrankSliderKernel.
+ */
+template<typename Scalar>
+struct CrankSliderState{
+    Scalar position = Scalar(0);
+    Scalar velocity = Scalar(0);
+    Scalar acceleration = Scalar(0);
+};
+
+/**
+ * The slider column of HodographKinematics with the precision and the
+ * options fixed at compile time:
+ *  Scalar  - type of the whole state, including the crank angle.
+ *  Method  - derivatives from central differences or analytic formulas.
+ *  Noise   - whether the rod length draws from the noise stream at all.
+ *
+ * Disabled options are not branched over at runtime, a kernel without
+ * noise never touches its stream. Finite differences describe the
+ * previous step, like HodographKinematics.
+ */
+template<typename Scalar, DerivativeMethod Method, bool Noise>
+class CrankSliderKernel{
+public:
+    typedef CrankSliderState<Scalar> State;
+
+    CrankSliderKernel(const HodographParameters& parameters,
+                      Scalar time_delta) :
+            radius_(parameters.radius),
+            line_length_(parameters.line_length),
+            error_(parameters.error),
+            angular_velocity_(parameters.angular_velocity),
+            time_delta_(time_delta),
+            alpha_(0),
+            line_error_length_(line_length_),
+            last_position_(0),
+            last_last_position_(0),
+            is_first_iteration_(true){}
+
+    Scalar alpha() const {return alpha_;}
+    Scalar line_error_length() const {return line_error_length_;}
+    const State& state() const {return state_;}
+
+    void Step(NoiseStream& noise_stream){
+        using std::sin;
+        using std::cos;
+
+        line_error_length_ = line_length_;
+        if(Noise){
+            line_error_length_ = line_error_length_
+                                 + error_ * Scalar(noise_stream.Next());
+        }
+        Scalar line_length = line_error_length_;
+
+        Scalar s = sin(alpha_);
+        Scalar c = cos(alpha_);
+        if(Method == DerivativeMethod::ANALYTIC){
+            // Like HodographKinematics, the analytic derivatives ignore
+            // the rod length error.
+            Scalar position;
+            EvaluateCrankSliderPoint(s, c, radius_, line_length_,
+                                     angular_velocity_, position,
+                                     state_.velocity, state_.acceleration);
+            state_.position = Noise ? SliderPosition(s, c, radius_,
+                                                     line_length)
+                                    : position;
+        }else{
+            UpdateDifferences(SliderPosition(s, c, radius_, line_length));
+        }
+        UpdateAlpha();
+    }
+
+private:
+    void UpdateDifferences(Scalar position){
+        if(is_first_iteration_){
+            last_position_ = position;
+            last_last_position_ = position;
+            is_first_iteration_ = false;
+        }else{
+            last_last_position_ = last_position_;
+            last_position_ = state_.position;
+        }
+        state_.position = position;
+        state_.velocity = (position - last_last_position_)
+                          / (Scalar(2) * time_delta_);
+        state_.acceleration = (position - Scalar(2) * last_position_
+                               + last_last_position_)
+                              / (time_delta_ * time_delta_);
+    }
+
+    void UpdateAlpha(){
+        using std::fmod;
+        // Wraps like HodographKinematics::ClampAlpha, in both directions.
+        const Scalar two_pi = Scalar(2 * M_PI);
+        alpha_ = alpha_ + angular_velocity_ * time_delta_;
+        if(alpha_ >= two_pi || alpha_ < Scalar(0)){
+            alpha_ = fmod(alpha_, two_pi);
+            if(alpha_ < Scalar(0))
+                alpha_ = alpha_ + two_pi;
+        }
+    }
+
+    Scalar radius_;
+    Scalar line_length_;
+    Scalar error_;
+    Scalar angular_velocity_;
+    Scalar time_delta_;
+
+    Scalar alpha_;
+    Scalar line_error_length_;
+    State state_;
+    Scalar last_position_;
+    Scalar last_last_position_;
+    bool is_first_iteration_;
+};
+
+#endif //PROJECT_CRANK_SLIDER_KERNEL_H
@@ -0,0 +1,95 @@
+#ifndef PROJECT_DUAL_H
+#define PROJECT_DUAL_H
+
+#include <cmath>
+
+/**
+ * Forward mode automatic differentiation: a value and its partial
+ * derivatives with respect to N independent variables. Every operation
+ * applies the chain rule, so a function written for a generic Scalar
+ * returns its result and all N derivatives in one evaluation.
+ *
+ * Floats convert implicitly to constants, the operators are friends so
+ * mixed expressions like 2 * x work.
+ */
+template<int N>
+struct Dual{
+    float value;
+    float d[N];
+
+    Dual(float value = 0) : value(value){
+        for(int i = 0; i < N; i++)
+            d[i] = 0;
+    }
+
+    /**
+     * Independent variable number index.
+     */
+    static Dual Variable(float value, int index){
+        Dual result(value);
+        result.d[index] = 1;
+        return result;
+    }
+
+    friend Dual operator+(const Dual& a, const Dual& b){
+        Dual result(a.value + b.value);
+        for(int i = 0; i < N; i++)
+            result.d[i] = a.d[i] + b.d[i];
+        return result;
+    }
+
+    friend Dual operator-(const Dual& a, const Dual& b){
+        Dual result(a.value - b.value);
+        for(int i = 0; i < N; i++)
+            result.d[i] = a.d[i] - b.d[i];
+        return result;
+    }
+
+    friend Dual operator-(const Dual& a){
+        Dual result(-a.value);
+        for(int i = 0; i < N; i++)
+            result.d[i] = -a.d[i];
+        return result;
+    }
+
+    friend Dual operator*(const Dual& a, const Dual& b){
+        Dual result(a.value * b.value);
+        for(int i = 0; i < N; i++)
+            result.d[i] = a.d[i] * b.value + a.value * b.d[i];
+        return result;
+    }
+
+    friend Dual operator/(const Dual& a, const Dual& b){
+        float inverse = 1 / b.value;
+        Dual result(a.value * inverse);
+        for(int i = 0; i < N; i++)
+            result.d[i] = (a.d[i] - result.value * b.d[i]) * inverse;
+        return result;
+    }
+
+    friend Dual sqrt(const Dual& a){
+        Dual result(std::sqrt(a.value));
+        float scale = 0.5f / result.value;
+        for(int i = 0; i < N; i++)
+            result.d[i] = a.d[i] * scale;
+        return result;
+    }
+
+    friend Dual sin(const Dual& a){
+        Dual result(std::sin(a.value));
+        float scale = std::cos(a.value);
+        for(int i = 0; i < N; i++)
+            result.d[i] = a.d[i] * scale;
+        return result;
+    }
+
+    friend Dual cos(const Dual& a){
+        Dual result(std::cos(a.value));
+        float scale = -std::sin(a.value);
+        for(int i = 0; i < N; i++)
+            result.d[i] = a.d[i] * scale;
+        return result;
+    }
+};
+
+#endif //PROJECT_DUAL_H
@@ -0,0 +1,100 @@
+#ifndef PROJECT_HODOGRAPH_CACHE_H
+#define PROJECT_HODOGRAPH_CACHE_H
+
+#include <kinematics/vec3.h>
+#include <containers/ring_buffer.h>
+#include <containers/min_max_pyramid.h>
+
+#include <cstddef>
+#include <vector>
+
+struct HodographSample{
+    Vec3 position;
+    Vec3 velocity;
+    Vec3 acceleration;
+};
+
+enum class HodographChannel{
+    POSITION = 0, VELOCITY = 1, ACCELERATION = 2
+};
+
+enum class Axis{
+    X = 0, Y = 1, Z = 2
+};
+
+const int HODOGRAPH_CHANNEL_COUNT = 3;
+const int AXIS_COUNT = 3;
+
+const unsigned int AXIS_MASK_X = 1 << 0;
+const unsigned int AXIS_MASK_Y = 1 << 1;
+const unsigned int AXIS_MASK_Z = 1 << 2;
+
+/**
+ * Bounded columnar history of the last capacity() samples.
+ *
+ * Every (channel, axis) pair is either a recorded float column or a constant.
+ * An axis that is constant so far is not recorded, it switches to its column
+ * the first time a different value is pushed. Every column is allocated by
+ * the constructor and SetCapacity, so Push never allocates. All columns share
+ * a single ring index, so View() of any column can be handed to
+ * ImGui::PlotLines directly.
+ * Each recorded column also keeps a MinMaxPyramid for Range/Resample.
+ */
+class HodographCache{
+public:
+    static const std::size_t DEFAULT_CAPACITY = 16384;
+
+    HodographCache(std::size_t capacity = DEFAULT_CAPACITY,
+                   unsigned int recorded_axes = AXIS_MASK_Z);
+    ~HodographCache();
+
+    std::size_t size() const {return size_;}
+    std::size_t capacity() const {return capacity_;}
+
+    /**
+     * Index of the oldest sample in the column storage.
+     */
+    std::size_t offset() const {return size_ == capacity_ ? head_ : 0;}
+
+    void Push(const HodographSample& sample);
+    void Clear();
+    void SetCapacity(std::size_t capacity);
+
+    bool IsRecorded(HodographChannel channel, Axis axis) const;
+    float Constant(HodographChannel channel, Axis axis) const;
+
+    /**
+     * Zero-copy view of a recorded column. Empty for constant axes.
+     */
+    RingView<float> View(HodographChannel channel, Axis axis) const;
+
+    float Get(HodographChannel channel, Axis axis, std::size_t i) const;
+    Vec3 Get(HodographChannel channel, std::size_t i) const;
+    HodographSample GetSample(std::size_t i) const;
+
+    /**
+     * Min/max of samples [begin, end), 0 is the oldest sample.
+     */
+    MinMax Range(HodographChannel channel, Axis axis,
+                 std::size_t begin, std::size_t end) const;
+    MinMax Resample(HodographChannel channel, Axis axis,
+                    std::size_t begin, std::size_t end,
+                    MinMax* columns, int width) const;
+
+    std::size_t memory_bytes() const;
+
+private:
+    void Push(int channel, const Vec3& value);
+    void EnableAxis(int channel, int axis);
+
+    std::vector<float> columns_[HODOGRAPH_CHANNEL_COUNT][AXIS_COUNT];
+    MinMaxPyramid pyramids_[HODOGRAPH_CHANNEL_COUNT][AXIS_COUNT];
+    float constants_[HODOGRAPH_CHANNEL_COUNT][AXIS_COUNT];
+    unsigned int recorded_axes_[HODOGRAPH_CHANNEL_COUNT];
+
+    std::size_t capacity_;
+    std::size_t head_;
+    std::size_t size_;
+};
+
+#endif //PROJECT_HODOGRAPH_CACHE_H
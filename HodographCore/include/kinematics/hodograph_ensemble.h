@@ -0,0 +1,80 @@
+#ifndef PROJECT_HODOGRAPH_ENSEMBLE_H
+#define PROJECT_HODOGRAPH_ENSEMBLE_H
+
+#include <kinematics/hodograph_parameters.h>
+#include <statistics/summary_statistics.h>
+#include <noise/noise_stream.h>
+
+#include <cstddef>
+#include <vector>
+
+struct EnsembleStep{
+    SummaryStatistics position;
+    SummaryStatistics velocity;
+    SummaryStatistics acceleration;
+};
+
+/**
+ * Monte-Carlo ensemble of independent crank-sliders that only differ in the
+ * noise drawn for their rod length. All members share the crank angle, so
+ * only the slider column is stored per member (structure of arrays) and
+ * advanced by a SIMD kernel.
+ */
+class HodographEnsemble {
+public:
+
+    HodographEnsemble(std::size_t size = 1024);
+    ~HodographEnsemble();
+
+    std::size_t size(){return z_.size();}
+    float alpha(){return (float)alpha_;}
+    const EnsembleStep& statistics(){return statistics_;}
+
+    const HodographParameters& parameters(){return parameters_;}
+    void parameters(const HodographParameters& value){parameters_ = value;}
+
+    const float* positions(){return z_.data();}
+    const float* velocities(){return velocities_.data();}
+    const float* accelerations(){return accelerations_.data();}
+
+    /**
+     * Member i draws normal number step * size() + i of the stream.
+     */
+    NoiseStream& noise_stream(){return noise_stream_;}
+
+    void Update(float time_delta);
+    void UpdateStatistics();
+
+    /**
+     * Reallocates the members and starts over from alpha = 0 and the first
+     * normal number of the noise stream.
+     */
+    void Reset(std::size_t size);
+    void Reset();
+
+private:
+    void UpdateNoise();
+    void UpdateMembers(float time_delta);
+    void UpdateAlpha(float time_delta);
+
+    HodographParameters parameters_;
+    /**
+     * Accumulated in double like HodographKinematics.
+     */
+    double alpha_;
+
+    NoiseStream noise_stream_;
+
+    std::vector<float> noise_;
+    std::vector<float> z_;
+    std::vector<float> z_last_;
+    std::vector<float> velocities_;
+    std::vector<float> accelerations_;
+
+    std::vector<float> scratch_;
+    EnsembleStep statistics_;
+
+    bool is_first_iteration_;
+};
+
+#endif //PROJECT_HODOGRAPH_ENSEMBLE_H
@@ -0,0 +1,246 @@
+#ifndef PROJECT_HODOGRAPH_KINEMATICS_H
+#define PROJECT_HODOGRAPH_KINEMATICS_H
+
+#include <kinematics/vec3.h>
+#include <kinematics/hodograph_cache.h>
+#include <kinematics/hodograph_parameters.h>
+#include <kinematics/crank_slider_analytic.h>
+#include <kinematics/dual.h>
+#include <kinematics/hodograph_sensitivity.h>
+#include <containers/ring_buffer.h>
+#include <filters/derivative_filter.h>
+#include <noise/noise_stream.h>
+#include <statistics/cycle_analyzer.h>
+#include <statistics/hodograph_statistics.h>
+
+/**
+ * Crank state of one step, replayed by the cycle analysis once the
+ * sample describing it arrives.
+ */
+struct CyclePhase {
+    double time;
+    double wrap_time;
+    float alpha;
+    float deviation;
+    bool wrapped;
+};
+
+struct Line {
+    Vec3 position0;
+    Vec3 position1;
+
+    Vec3 last_position1;
+    Vec3 last_last_position1;
+};
+
+typedef Dual<SENSITIVITY_PARAMETER_COUNT> SensitivityDual;
+
+/**
+ * Crank-slider kinematics without any rendering dependencies.
+ * Used by HodographSimulation and by the headless batch runner.
+ */
+class HodographKinematics {
+public:
+
+    HodographKinematics(
+            std::size_t cache_capacity = HodographCache::DEFAULT_CAPACITY);
+    ~HodographKinematics();
+
+    float* angular_velocity(){return &parameters_.angular_velocity;}
+    float* radius(){return &parameters_.radius;}
+    float* line_length(){return &parameters_.line_length;}
+    float* error(){return &parameters_.error;}
+
+    const HodographParameters& parameters(){return parameters_;}
+    void parameters(const HodographParameters& value);
+
+    float line_error_length(){return line_error_length_;}
+    float alpha(){return (float)alpha_;}
+    const Line& line(){return line_;}
+    const HodographSample& sample(){return sample_;}
+    /**
+     * False while the derivatives of sample() still difference the
+     * history seeded with the first position: the first 2 samples of
+     * central differences and the first kernel length - 1 samples after
+     * the filter was configured. Analytic samples are always valid.
+     * Statistics skip invalid samples.
+     */
+    bool sample_valid(){return sample_valid_;}
+    HodographCache& hodograph_cache(){return hodograph_cache_;}
+
+    bool cache_enabled(){return cache_enabled_;}
+    void cache_enabled(bool value){cache_enabled_ = value;}
+
+    /**
+     * Running statistics of every sample since the last ResetCache,
+     * updated even while the cache is disabled.
+     */
+    const HodographStatistics& statistics(){return statistics_;}
+    void ResetStatistics(){statistics_.Clear();}
+    bool statistics_enabled(){return statistics_enabled_;}
+    void statistics_enabled(bool value){statistics_enabled_ = value;}
+
+    double time(){return time_;}
+
+    DerivativeMethod derivative_method(){return derivative_method_;}
+    void derivative_method(DerivativeMethod value){derivative_method_ = value;}
+
+    /**
+     * Smoothing of the finite differences, ignored by the analytic method.
+     * The filtered sample lags FilterGroupDelay() steps behind the crank.
+     */
+    const FilterSettings& filter_settings(){return filter_settings_;}
+    void filter_settings(const FilterSettings& value){
+        filter_settings_ = value;}
+
+    /**
+     * When enabled, derivative_difference() holds the finite difference
+     * result minus the analytic derivatives at the same step, the central
+     * step or the filter group delay in the past.
+     */
+    bool diagnostics_enabled(){return diagnostics_enabled_;}
+    void diagnostics_enabled(bool value){diagnostics_enabled_ = value;}
+    const HodographSample& derivative_difference(){
+        return derivative_difference_;}
+
+    /**
+     * When enabled, sensitivity() holds the derivatives of the unfiltered
+     * sample with respect to the parameters. The slider position is
+     * evaluated on dual numbers next to the float one and differentiated
+     * like the sample, by central differences or analytically.
+     *
+     * The angular velocity derivatives assume w was constant since it was
+     * last changed or since the last ResetCache, whichever came later.
+     */
+    bool sensitivity_enabled(){return sensitivity_enabled_;}
+    void sensitivity_enabled(bool value){sensitivity_enabled_ = value;}
+    const HodographSensitivity& sensitivity(){return sensitivity_;}
+
+    /**
+     * When enabled, every revolution is summarized into a CycleRecord.
+     * Samples are attributed to the crank angle and time they describe,
+     * central differences lag 1 step and filters their group delay, so
+     * cycle_completed() is true for the step whose sample crossed the
+     * wrap. cycles().last() then holds the finished revolution. After
+     * Step, read the new records from cycles().history(). Invalid
+     * samples are skipped.
+     */
+    bool cycles_enabled(){return cycles_enabled_;}
+    void cycles_enabled(bool value){cycles_enabled_ = value;}
+    const CycleAnalyzer& cycles(){return cycles_;}
+    bool cycle_completed(){return cycle_completed_;}
+
+    /**
+     * Rod length noise, one normal number per step.
+     */
+    NoiseStream& noise_stream(){return noise_stream_;}
+
+    void Update(float time_delta);
+
+    /**
+     * Same as count calls to Update, with sin and cos of the crank angle
+     * from AngleRotation instead of trig calls. The rotation is
+     * re-anchored whenever the angle wraps and follows the exact step in
+     * between, so it differs from Update only by rounding.
+     *
+     * Writes the sample of every step to samples unless it is null.
+     * Never allocates.
+     */
+    void Step(std::size_t count, float time_delta, HodographSample* samples);
+
+    void ResetCache();
+private:
+    /**
+     * One step with sin_alpha_ and cos_alpha_ already set for alpha_.
+     */
+    void Advance(float time_delta);
+
+    void UpdateLine(float time_delta);
+    void UpdateErrorLine();
+    void UpdateLinePosition(float time_delta);
+    void UpdateLinePosition0();
+    void UpdateLinePosition1();
+    void UpdateLineSensitivity();
+
+    void UpdateAlpha(float time_delta);
+    void ClampAlpha();
+
+    void UpdateSample(float time_delta);
+    void UpdateAnalyticSample();
+    void UpdateSampleSensitivity(float time_delta);
+    void UpdateCache();
+    void UpdateCycles(float time_delta);
+
+    /**
+     * Steps sample_ lags behind the crank angle it was computed at.
+     */
+    std::size_t SampleDelay();
+
+    HodographParameters parameters_;
+    /**
+     * Accumulated in double like LinkageKinematics, in float a long run
+     * drifts by thousands of steps' worth of rounding.
+     */
+    double alpha_;
+    /**
+     * Set by ClampAlpha when alpha_ wrapped in the last step.
+     */
+    bool wrapped_;
+    /**
+     * Crank angle the current line and sample were computed at.
+     */
+    double sample_alpha_;
+
+    float sin_alpha_;
+    float cos_alpha_;
+
+    float line_error_length_;
+    NoiseStream noise_stream_;
+
+    Line line_;
+    /**
+     * Distinct positions in the line_ history, up to 3.
+     */
+    int line_history_size_;
+    HodographSample sample_;
+    bool sample_valid_;
+
+    DerivativeMethod derivative_method_;
+    bool diagnostics_enabled_;
+    HodographSample analytic_sample_;
+    RingBuffer<HodographSample> analytic_history_;
+    HodographSample derivative_difference_;
+
+    bool sensitivity_enabled_;
+    HodographSensitivity sensitivity_;
+    /**
+     * d(alpha) / d(angular velocity), the time the crank turned at the
+     * current angular velocity. Stepped with alpha_.
+     */
+    double alpha_angular_velocity_derivative_;
+    SensitivityDual dual_sin_alpha_;
+    SensitivityDual dual_cos_alpha_;
+    SensitivityDual dual_position1_;
+    SensitivityDual dual_last_position1_;
+    SensitivityDual dual_last_last_position1_;
+
+    DerivativeFilter filter_;
+    FilterSettings filter_settings_;
+
+    HodographCache hodograph_cache_;
+    bool cache_enabled_;
+
+    HodographStatistics statistics_;
+    bool statistics_enabled_;
+
+    CycleAnalyzer cycles_;
+    RingBuffer<CyclePhase> cycle_phases_;
+    bool cycles_enabled_;
+    bool cycle_completed_;
+    float error_deviation_;
+    double time_;
+
+    bool is_first_iteration_;
+};
+
+#endif //PROJECT_HODOGRAPH_KINEMATICS_H
@@ -0,0 +1,24 @@
+#ifndef PROJECT_HODOGRAPH_PARAMETERS_H
+#define PROJECT_HODOGRAPH_PARAMETERS_H
+
+struct HodographParameters{
+    float angular_velocity = 1;
+    float radius = 1;
+    float line_length = 3;
+    float error = 0;
+};
+
+inline bool operator==(const HodographParameters& a,
+                       const HodographParameters& b){
+    return a.angular_velocity == b.angular_velocity
+           && a.radius == b.radius
+           && a.line_length == b.line_length
+           && a.error == b.error;
+}
+
+inline bool operator!=(const HodographParameters& a,
+                       const HodographParameters& b){
+    return !(a == b);
+}
+
+#endif //PROJECT_HODOGRAPH_PARAMETERS_H
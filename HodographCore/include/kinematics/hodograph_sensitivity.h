@@ -0,0 +1,34 @@
+#ifndef PROJECT_HODOGRAPH_SENSITIVITY_H
+#define PROJECT_HODOGRAPH_SENSITIVITY_H
+
+enum class SensitivityParameter{
+    RADIUS = 0, LINE_LENGTH = 1, ANGULAR_VELOCITY = 2
+};
+
+const int SENSITIVITY_PARAMETER_COUNT = 3;
+
+/**
+ * Partial derivatives of the slider position, velocity and acceleration
+ * (z) with respect to one parameter.
+ */
+struct SliderSensitivity{
+    float position = 0;
+    float velocity = 0;
+    float acceleration = 0;
+};
+
+/**
+ * Sensitivities of one step to every HodographParameters entry but the
+ * error, indexed by SensitivityParameter. The crank angle is w t, its
+ * derivative with respect to w grows with t and so do the
+ * angular_velocity entries.
+ */
+struct HodographSensitivity{
+    SliderSensitivity parameters[SENSITIVITY_PARAMETER_COUNT];
+
+    const SliderSensitivity& Get(SensitivityParameter parameter) const {
+        return parameters[static_cast<int>(parameter)];
+    }
+};
+
+#endif //PROJECT_HODOGRAPH_SENSITIVITY_H
@@ -0,0 +1,29 @@
+#ifndef PROJECT_VEC3_H
+#define PROJECT_VEC3_H
+
+struct Vec3 {
+    float x;
+    float y;
+    float z;
+
+    Vec3() : x(0), y(0), z(0){}
+    Vec3(float x, float y, float z) : x(x), y(y), z(z){}
+};
+
+inline Vec3 operator+(const Vec3& a, const Vec3& b){
+    return Vec3(a.x + b.x, a.y + b.y, a.z + b.z);
+}
+
+inline Vec3 operator-(const Vec3& a, const Vec3& b){
+    return Vec3(a.x - b.x, a.y - b.y, a.z - b.z);
+}
+
+inline Vec3 operator*(const Vec3& a, float s){
+    return Vec3(a.x * s, a.y * s, a.z * s);
+}
+
+inline Vec3 operator/(const Vec3& a, float s){
+    return Vec3(a.x / s, a.y / s, a.z / s);
+}
+
+#endif //PROJECT_VEC3_H
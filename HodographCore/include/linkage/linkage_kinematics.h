@@ -0,0 +1,82 @@
+#ifndef PROJECT_LINKAGE_KINEMATICS_H
+#define PROJECT_LINKAGE_KINEMATICS_H
+
+#include <kinematics/hodograph_cache.h>
+#include <kinematics/hodograph_parameters.h>
+#include <linkage/linkage_mechanism.h>
+#include <noise/noise_stream.h>
+
+/**
+ * HodographKinematics for any MechanismType: the output joint of a
+ * PlanarLinkage solved every step, with the rod length noise on the
+ * coupler. Velocity and acceleration come from the solver, exact for the
+ * current assembly.
+ *
+ * A step the linkage cannot be assembled in (dead center, rod too short)
+ * keeps the last sample and counts as singular, the crank keeps turning.
+ */
+class LinkageKinematics{
+public:
+    LinkageKinematics(
+            std::size_t cache_capacity = HodographCache::DEFAULT_CAPACITY);
+    ~LinkageKinematics();
+
+    const HodographParameters& parameters(){return parameters_;}
+    void parameters(const HodographParameters& value);
+
+    const MechanismSettings& mechanism(){return settings_;}
+    void mechanism(const MechanismSettings& value);
+
+    float alpha(){return (float)alpha_;}
+    float line_error_length(){return line_error_length_;}
+    /**
+     * Crank tip, like HodographKinematics::line().position0.
+     */
+    const Vec3& position0(){return position0_;}
+    const HodographSample& sample(){return sample_;}
+    double time(){return time_;}
+
+    const PlanarLinkage& linkage(){return mechanism_.linkage;}
+    LinkageStatus status(){return status_;}
+    int iterations(){return mechanism_.linkage.iterations();}
+    unsigned long long singular_steps(){return singular_steps_;}
+
+    HodographCache& hodograph_cache(){return hodograph_cache_;}
+    bool cache_enabled(){return cache_enabled_;}
+    void cache_enabled(bool value){cache_enabled_ = value;}
+
+    /**
+     * Rod length noise, one normal number per step.
+     */
+    NoiseStream& noise_stream(){return noise_stream_;}
+
+    void Update(float time_delta);
+
+    void ResetCache();
+private:
+    /**
+     * Rebuilds the linkage at the current crank angle, the warm start
+     * does not survive a change of geometry.
+     */
+    void Rebuild();
+    void UpdateAlpha(float time_delta);
+
+    HodographParameters parameters_;
+    MechanismSettings settings_;
+    Mechanism mechanism_;
+
+    double alpha_;
+    float line_error_length_;
+    NoiseStream noise_stream_;
+
+    Vec3 position0_;
+    HodographSample sample_;
+    LinkageStatus status_;
+    unsigned long long singular_steps_;
+
+    HodographCache hodograph_cache_;
+    bool cache_enabled_;
+    double time_;
+};
+
+#endif //PROJECT_LINKAGE_KINEMATICS_H
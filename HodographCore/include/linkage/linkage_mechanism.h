@@ -0,0 +1,79 @@
+#ifndef PROJECT_LINKAGE_MECHANISM_H
+#define PROJECT_LINKAGE_MECHANISM_H
+
+#include <kinematics/hodograph_parameters.h>
+#include <linkage/planar_linkage.h>
+
+enum class MechanismType{
+    /**
+     * Closed form HodographKinematics, no linkage solver.
+     */
+    CRANK_SLIDER,
+    /**
+     * Slider on the line y = offset.
+     */
+    OFFSET_SLIDER_CRANK,
+    /**
+     * Crank, coupler and a rocker pivoting at (ground, 0), the output is
+     * the coupler-rocker joint.
+     */
+    FOUR_BAR,
+    /**
+     * FOUR_BAR driving a slider on y = 0 through a rod of output_length
+     * from the coupler-rocker joint.
+     */
+    TWO_LOOP
+};
+
+/**
+ * Geometry beyond HodographParameters, the crank radius and the coupler
+ * (rod) length always come from the parameters.
+ */
+struct MechanismSettings{
+    MechanismType type = MechanismType::CRANK_SLIDER;
+    float offset = 0;
+    float ground = 3;
+    float rocker = 2.5;
+    float output_length = 3;
+};
+
+inline bool operator==(const MechanismSettings& a,
+                       const MechanismSettings& b){
+    return a.type == b.type
+           && a.offset == b.offset
+           && a.ground == b.ground
+           && a.rocker == b.rocker
+           && a.output_length == b.output_length;
+}
+
+inline bool operator!=(const MechanismSettings& a,
+                       const MechanismSettings& b){
+    return !(a == b);
+}
+
+const char* MechanismName(MechanismType type);
+
+/**
+ * Linkage with the joints HodographKinematics reports.
+ */
+struct Mechanism{
+    PlanarLinkage linkage;
+    int crank = -1;
+    int output = -1;
+    /**
+     * DISTANCE constraint of the rod, its length carries the noise.
+     */
+    int coupler = -1;
+};
+
+/**
+ * Builds the linkage of settings.type with the crank center at the
+ * origin. The first guesses are the assembly at crank angle alpha with
+ * the coupler-rocker joint above the line between its pivots. CRANK_SLIDER
+ * gives the zero offset slider crank.
+ */
+Mechanism CreateMechanism(const MechanismSettings& settings,
+                          const HodographParameters& parameters,
+                          double alpha = 0);
+
+#endif //PROJECT_LINKAGE_MECHANISM_H
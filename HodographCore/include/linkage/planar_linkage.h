@@ -0,0 +1,172 @@
+#ifndef PROJECT_PLANAR_LINKAGE_H
+#define PROJECT_PLANAR_LINKAGE_H
+
+#include <kinematics/hodograph_cache.h>
+
+struct Point2{
+    double x;
+    double y;
+
+    Point2() : x(0), y(0){}
+    Point2(double x, double y) : x(x), y(y){}
+};
+
+enum class JointType{
+    FIXED, CRANK, FREE
+};
+
+struct LinkageJoint{
+    JointType type = JointType::FREE;
+
+    /**
+     * CRANK only, the center must be a FIXED joint.
+     */
+    int center = -1;
+    double radius = 0;
+    double phase = 0;
+
+    Point2 position;
+    /**
+     * First and second derivative with respect to the crank angle.
+     */
+    Point2 derivative;
+    Point2 second_derivative;
+};
+
+enum class ConstraintType{
+    /**
+     * |p_a - p_b| = length, a rigid link between two joints.
+     */
+    DISTANCE,
+    /**
+     * normal . (p_a - origin) = 0, joint a slides along a fixed line.
+     */
+    SLIDER
+};
+
+struct LinkageConstraint{
+    ConstraintType type = ConstraintType::DISTANCE;
+    int a = -1;
+    int b = -1;
+    double length = 0;
+    Point2 origin;
+    Point2 normal;
+};
+
+enum class LinkageStatus{
+    OK,
+    /**
+     * Jacobian singular at the solution (dead center, toggle position) or
+     * the linkage is not square.
+     */
+    SINGULAR,
+    /**
+     * No assembly near the previous one, e.g. a rod too short to reach.
+     */
+    NOT_CONVERGED
+};
+
+/**
+ * Planar mechanism of joints tied by distance and slider constraints,
+ * driven by cranks on a common crank angle alpha.
+ *
+ * Solve finds the FREE joint positions with Newton's method on the
+ * constraint equations. It starts from the previous solution advanced by
+ * its first two alpha derivatives, so a step of a smooth motion typically
+ * converges in a single iteration. The derivatives come from the same
+ * LU factorization of the Jacobian:
+ *   J q'  = -Phi_alpha
+ *   J q'' = -(Phi_alpha,alpha + gamma(q'))
+ * and give velocity w q' and acceleration w^2 q'' at constant w.
+ *
+ * Everything lives in fixed size arrays, Solve never allocates. The Add
+ * functions return the new index, or -1 once MAX_JOINTS joints,
+ * MAX_UNKNOWNS constraints or MAX_UNKNOWNS / 2 FREE joints exist or a
+ * joint index is out of range. A failed Solve keeps the last valid state.
+ */
+class PlanarLinkage{
+public:
+    static const int MAX_JOINTS = 8;
+    static const int MAX_UNKNOWNS = 12;
+    static const int MAX_ITERATIONS = 16;
+
+    PlanarLinkage();
+    ~PlanarLinkage();
+
+    int AddFixed(double x, double y);
+
+    /**
+     * Tip at center + radius (sin(alpha + phase), cos(alpha + phase)),
+     * the angle convention of HodographKinematics.
+     */
+    int AddCrank(int center, double radius, double phase = 0);
+
+    /**
+     * (x, y) is the first guess, it selects the assembly mode.
+     */
+    int AddFree(double x, double y);
+
+    int AddDistance(int a, int b, double length);
+    int AddSlider(int joint, const Point2& origin, const Point2& direction);
+
+    double length(int constraint) const {
+        return constraints_[constraint].length;}
+    void length(int constraint, double value){
+        constraints_[constraint].length = value;}
+
+    bool is_square() const {return constraint_count_ == unknown_count_;}
+    bool is_joint(int index) const {
+        return index >= 0 && index < joint_count_;}
+
+    int joint_count() const {return joint_count_;}
+    const LinkageJoint& joint(int index) const {return joints_[index];}
+
+    /**
+     * Newton iterations of the last Solve.
+     */
+    int iterations() const {return iterations_;}
+
+    LinkageStatus Solve(double alpha);
+
+    /**
+     * Forgets the warm start, the next Solve starts from the first guesses.
+     */
+    void Reset();
+
+    /**
+     * Joint as a slider sample at constant angular velocity, the plane
+     * (x, y) maps to (z, y) like HodographKinematics.
+     */
+    HodographSample Sample(int joint, double angular_velocity) const;
+
+private:
+    void UpdateCranks(double alpha);
+    void Predict(double alpha);
+    void Evaluate(double* residual, double* jacobian) const;
+    void Gradients(const LinkageConstraint& constraint,
+                   Point2& gradient_a, Point2& gradient_b) const;
+    double Tolerance() const;
+    void UpdateDerivatives(const double* factors, const int* pivots);
+
+    void AddColumn(double* row, int joint, const Point2& gradient) const;
+    double Known(int joint, const Point2& gradient, bool second) const;
+
+    LinkageJoint joints_[MAX_JOINTS];
+    LinkageJoint previous_[MAX_JOINTS];
+    Point2 guesses_[MAX_JOINTS];
+    /**
+     * First unknown of every FREE joint, -1 for the others.
+     */
+    int unknowns_[MAX_JOINTS];
+    LinkageConstraint constraints_[MAX_UNKNOWNS];
+
+    int joint_count_;
+    int constraint_count_;
+    int unknown_count_;
+
+    double alpha_;
+    bool solved_;
+    int iterations_;
+};
+
+#endif //PROJECT_PLANAR_LINKAGE_H
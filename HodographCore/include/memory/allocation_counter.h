@@ -0,0 +1,40 @@
+#ifndef PROJECT_ALLOCATION_COUNTER_H
+#define PROJECT_ALLOCATION_COUNTER_H
+
+#include <cstddef>
+
+struct AllocationStats{
+    unsigned long long count;
+    unsigned long long bytes;
+};
+
+/**
+ * Counts heap allocations made by the calling thread since construction
+ * or the last Reset(). Allocations are only seen in binaries that add the
+ * hodograph_allocation_hooks objects, which replace the global operator
+ * new. Everywhere else the counts stay 0 and enabled() is false.
+ */
+class AllocationCounter{
+public:
+    AllocationCounter();
+    ~AllocationCounter();
+
+    unsigned long long count() const;
+    unsigned long long bytes() const;
+
+    void Reset();
+
+    static AllocationStats ThreadStats();
+
+    static bool enabled();
+
+    /**
+     * Called by the replaced operator new.
+     */
+    static void Enable();
+    static void Record(std::size_t size);
+private:
+    AllocationStats start_;
+};
+
+#endif //PROJECT_ALLOCATION_COUNTER_H
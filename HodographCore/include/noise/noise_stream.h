@@ -0,0 +1,62 @@
+#ifndef PROJECT_NOISE_STREAM_H
+#define PROJECT_NOISE_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Deterministic standard normal numbers.
+ *
+ * Normal number i of a stream is a pure function of (seed, stream, i):
+ * a Philox4x32-10 counter-based generator turns block i / 4 into four
+ * uniforms and Box-Muller turns those into four normals. Streams with
+ * different ids never overlap, so parallel workers stay independent and
+ * results do not depend on scheduling.
+ */
+class NoiseStream{
+public:
+    static const std::size_t BUFFER_SIZE = 256;
+
+    NoiseStream(uint64_t seed = 0, uint64_t stream = 0);
+    ~NoiseStream();
+
+    uint64_t seed() const {return seed_;}
+    uint64_t stream() const {return stream_;}
+
+    /**
+     * Index of the next normal number.
+     */
+    uint64_t counter() const {return buffer_start_ + buffer_position_;}
+
+    void Reset(uint64_t seed, uint64_t stream);
+    void Seek(uint64_t counter);
+
+    float Next(){
+        if(buffer_position_ == BUFFER_SIZE)
+            Refill();
+        return buffer_[buffer_position_++];
+    }
+
+    /**
+     * Writes the next count normals, continuing from counter().
+     */
+    void Fill(float* normals, std::size_t count);
+
+    /**
+     * Normals [counter, counter + count) of (seed, stream), stateless.
+     */
+    static void Generate(uint64_t seed, uint64_t stream, uint64_t counter,
+                         float* normals, std::size_t count);
+
+private:
+    void Refill();
+
+    uint64_t seed_;
+    uint64_t stream_;
+
+    float buffer_[BUFFER_SIZE];
+    uint64_t buffer_start_;
+    std::size_t buffer_position_;
+};
+
+#endif //PROJECT_NOISE_STREAM_H
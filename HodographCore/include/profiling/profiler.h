@@ -0,0 +1,131 @@
+#ifndef PROJECT_PROFILER_H
+#define PROJECT_PROFILER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * One timed stage, times in nanoseconds of Profiler::Now().
+ */
+struct ProfileEvent{
+    const char* name;
+    uint64_t begin;
+    uint64_t end;
+    unsigned int thread;
+};
+
+struct ProfileThread{
+    unsigned int id;
+    std::string name;
+};
+
+/**
+ * Durations of all events of one stage, in microseconds.
+ */
+struct StageStatistics{
+    const char* name;
+    std::size_t count;
+    float p50;
+    float p99;
+    float max;
+};
+
+/**
+ * Process wide stage timer. Every thread records into its own ring buffer
+ * of the last BUFFER_CAPACITY events, so recording never locks and other
+ * threads can read the buffers at any time. While disabled a ProfileScope
+ * costs a relaxed load and a branch.
+ *
+ * Event names must be string literals, only the pointer is stored.
+ */
+class Profiler{
+public:
+    static const std::size_t BUFFER_CAPACITY = 16384;
+
+    static bool enabled(){
+        return enabled_.load(std::memory_order_relaxed);}
+    static void enabled(bool value){
+        enabled_.store(value, std::memory_order_relaxed);}
+
+    /**
+     * Also records the stages inside a single kinematics step. Each of
+     * them costs about as much as the step itself, so they are off
+     * unless asked for. Only has an effect while enabled().
+     */
+    static bool detailed(){
+        return enabled() && detailed_.load(std::memory_order_relaxed);}
+    static void detailed(bool value){
+        detailed_.store(value, std::memory_order_relaxed);}
+
+    static uint64_t Now();
+
+    static void Record(const char* name, uint64_t begin, uint64_t end);
+
+    /**
+     * Names the calling thread in exported traces.
+     */
+    static void SetThreadName(const std::string& name);
+
+    /**
+     * Appends the buffered events of all threads that began at or after
+     * since, in no particular order.
+     */
+    static void Collect(std::vector<ProfileEvent>& events, uint64_t since = 0);
+    static std::vector<ProfileThread> Threads();
+
+    /**
+     * Hides all events recorded so far from Collect.
+     */
+    static void Clear();
+
+private:
+    static std::atomic<bool> enabled_;
+    static std::atomic<bool> detailed_;
+};
+
+/**
+ * Records the time from construction to destruction as one event.
+ */
+class ProfileScope{
+public:
+    explicit ProfileScope(const char* name) :
+            ProfileScope(name, Profiler::enabled()){}
+
+    /**
+     * Records only if record is true, e.g. Profiler::detailed().
+     */
+    ProfileScope(const char* name, bool record) :
+            name_(record ? name : nullptr),
+            begin_(name_ ? Profiler::Now() : 0){}
+
+    ~ProfileScope(){
+        if(name_)
+            Profiler::Record(name_, begin_, Profiler::Now());
+    }
+
+private:
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+    const char* name_;
+    uint64_t begin_;
+};
+
+/**
+ * Groups events by name, sorted by name. Reuses the storage of statistics.
+ */
+void ComputeStageStatistics(const std::vector<ProfileEvent>& events,
+                            std::vector<StageStatistics>& statistics);
+
+/**
+ * Writes events as Chrome trace-event JSON, viewable in chrome://tracing
+ * or Perfetto. Returns false if the file cannot be written.
+ */
+bool WriteChromeTrace(const std::string& path,
+                      const std::vector<ProfileEvent>& events,
+                      const std::vector<ProfileThread>& threads);
+
+#endif //PROJECT_PROFILER_H
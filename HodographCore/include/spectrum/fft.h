@@ -0,0 +1,27 @@
+#ifndef PROJECT_FFT_H
+#define PROJECT_FFT_H
+
+#include <containers/ring_buffer.h>
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+bool IsPowerOfTwo(std::size_t n);
+
+/**
+ * In-place iterative radix-2 FFT, n must be a power of two.
+ */
+void FftRadix2(std::complex<float>* data, std::size_t n);
+
+/**
+ * Amplitude spectrum of the newest n samples of a ring view, Hann
+ * windowed, bin 0 holds the absolute mean.
+ * Writes n / 2 + 1 bins, bin k is at k / (n * time_delta) Hz.
+ * Returns false if the view holds fewer than n samples.
+ */
+bool ComputeAmplitudeSpectrum(const RingView<float>& samples, std::size_t n,
+                              std::vector<std::complex<float>>& scratch,
+                              std::vector<float>& amplitudes);
+
+#endif //PROJECT_FFT_H
@@ -0,0 +1,47 @@
+#ifndef PROJECT_SLIDING_DFT_H
+#define PROJECT_SLIDING_DFT_H
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+/**
+ * DFT bins of the last window samples, updated in O(bins) per sample:
+ *  S_k(n) = (S_k(n - 1) + x(n) - x(n - window)) * exp(2 pi i k / window)
+ *
+ * The recursion accumulates rounding error, so once per window the bins
+ * are recomputed from the stored samples, O(bins) per sample amortized.
+ */
+class SlidingDft{
+public:
+    SlidingDft(std::size_t window = 1, std::size_t bins = 1);
+    ~SlidingDft();
+
+    std::size_t window() const {return samples_.size();}
+    std::size_t bins() const {return bins_.size();}
+    std::size_t size() const {return size_;}
+    bool full() const {return size_ == samples_.size();}
+
+    void Push(float x);
+    void Reset(std::size_t window, std::size_t bins);
+    void Clear();
+
+    /**
+     * Amplitude of the sinusoid in bin k: |S_k| / window for the mean,
+     * 2 |S_k| / window otherwise. Partial windows are not rescaled.
+     */
+    float Amplitude(std::size_t k) const;
+
+private:
+    void Recompute();
+
+    std::vector<float> samples_;
+    std::size_t head_;
+    std::size_t size_;
+    std::size_t since_recompute_;
+
+    std::vector<std::complex<double>> bins_;
+    std::vector<std::complex<double>> twiddles_;
+};
+
+#endif //PROJECT_SLIDING_DFT_H
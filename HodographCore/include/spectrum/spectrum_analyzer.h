@@ -0,0 +1,68 @@
+#ifndef PROJECT_SPECTRUM_ANALYZER_H
+#define PROJECT_SPECTRUM_ANALYZER_H
+
+#include <kinematics/hodograph_cache.h>
+#include <spectrum/sliding_dft.h>
+
+#include <complex>
+#include <vector>
+
+/**
+ * Harmonic content of the slider axis (z) of position, velocity and
+ * acceleration.
+ *
+ * Harmonics of the angular velocity are tracked per sample by a sliding
+ * DFT whose window is one crank revolution, so bin k is harmonic k. The
+ * full spectrum is an FFT over the cache, meant to be refreshed
+ * periodically rather than every frame.
+ */
+class SpectrumAnalyzer{
+public:
+    static const std::size_t DEFAULT_HARMONICS = 8;
+    static const std::size_t MAX_WINDOW = 1 << 20;
+
+    SpectrumAnalyzer(std::size_t harmonics = DEFAULT_HARMONICS);
+    ~SpectrumAnalyzer();
+
+    /**
+     * Starts over when the revolution length in samples or the number of
+     * harmonics changes.
+     */
+    void Configure(float angular_velocity, double time_delta,
+                   std::size_t harmonics);
+
+    void Push(const HodographSample& sample);
+    void Clear();
+
+    /**
+     * FFT of the newest fft_size samples of every channel.
+     * Returns false until the cache holds that many samples.
+     */
+    bool UpdateFft(const HodographCache& cache, std::size_t fft_size);
+
+    std::size_t harmonics() const {return dfts_[0].bins() - 1;}
+
+    /**
+     * Bin 0 is the mean, bin k harmonic k.
+     */
+    const SlidingDft& dft(HodographChannel channel) const {
+        return dfts_[static_cast<int>(channel)];}
+
+    const std::vector<float>& fft(HodographChannel channel) const {
+        return ffts_[static_cast<int>(channel)];}
+
+    /**
+     * Hz per FFT bin.
+     */
+    float fft_resolution() const {return fft_resolution_;}
+
+private:
+    SlidingDft dfts_[HODOGRAPH_CHANNEL_COUNT];
+    std::vector<float> ffts_[HODOGRAPH_CHANNEL_COUNT];
+    std::vector<std::complex<float>> scratch_;
+
+    double time_delta_;
+    float fft_resolution_;
+};
+
+#endif //PROJECT_SPECTRUM_ANALYZER_H
@@ -0,0 +1,94 @@
+#ifndef PROJECT_CYCLE_ANALYZER_H
+#define PROJECT_CYCLE_ANALYZER_H
+
+#include <kinematics/hodograph_cache.h>
+#include <containers/ring_buffer.h>
+
+#include <cstdint>
+
+/**
+ * Summary of one crank revolution, 56 bytes. Times are relative to the
+ * start of the revolution, angles are crank angles in radians.
+ */
+struct CycleRecord{
+    uint32_t index;
+    uint32_t samples;
+    double start_time;
+    float period;
+
+    /**
+     * Slider extremes, stroke = top_position - bottom_position.
+     */
+    float top_position;
+    float bottom_position;
+    float top_time;
+    float bottom_time;
+
+    /**
+     * Largest |velocity| and |acceleration| (signed) and their angles.
+     */
+    float peak_velocity;
+    float peak_velocity_alpha;
+    float peak_acceleration;
+    float peak_acceleration_alpha;
+
+    /**
+     * RMS of the slider position minus the position without rod length
+     * error.
+     */
+    float error_rms;
+
+    float stroke() const {return top_position - bottom_position;}
+};
+
+static_assert(sizeof(CycleRecord) == 56, "CycleRecord layout changed");
+
+/**
+ * Folds the slider samples of a revolution into a CycleRecord, O(1) per
+ * sample and without storing any of them. The owner calls Push for every
+ * step and Finish when the crank angle wraps. The latest records are kept
+ * in a fixed ring, history()[i].index tells which revolution they are.
+ */
+class CycleAnalyzer{
+public:
+    static const std::size_t DEFAULT_HISTORY_CAPACITY = 1024;
+
+    CycleAnalyzer(std::size_t history_capacity = DEFAULT_HISTORY_CAPACITY);
+    ~CycleAnalyzer();
+
+    /**
+     * Revolutions finished since the last Clear.
+     */
+    uint32_t cycles() const {return cycles_;}
+    const RingBuffer<CycleRecord>& history() const {return history_;}
+    /**
+     * Only valid if cycles() > 0.
+     */
+    const CycleRecord& last() const {return history_.back();}
+
+    /**
+     * alpha is the crank angle the sample belongs to, deviation the
+     * position error caused by the rod length noise.
+     */
+    void Push(double time, float alpha, const HodographSample& sample,
+              float deviation);
+
+    /**
+     * Closes the current revolution at time, returns false if it has no
+     * samples.
+     */
+    bool Finish(double time);
+
+    void Clear();
+
+private:
+    void Start(double time);
+
+    CycleRecord current_;
+    RingBuffer<CycleRecord> history_;
+    uint32_t cycles_;
+    double deviation_sum_sqr_;
+    bool started_;
+};
+
+#endif //PROJECT_CYCLE_ANALYZER_H
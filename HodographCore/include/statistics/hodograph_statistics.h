@@ -0,0 +1,40 @@
+#ifndef PROJECT_HODOGRAPH_STATISTICS_H
+#define PROJECT_HODOGRAPH_STATISTICS_H
+
+#include <kinematics/hodograph_cache.h>
+#include <statistics/running_statistics.h>
+
+/**
+ * RunningStatistics of every channel and axis, fed next to the
+ * HodographCache but independent of its capacity.
+ */
+class HodographStatistics{
+public:
+    void Push(const HodographSample& sample, double time){
+        Push(HodographChannel::POSITION, sample.position, time);
+        Push(HodographChannel::VELOCITY, sample.velocity, time);
+        Push(HodographChannel::ACCELERATION, sample.acceleration, time);
+    }
+
+    void Clear(){
+        for(int c = 0; c < HODOGRAPH_CHANNEL_COUNT; c++)
+            for(int a = 0; a < AXIS_COUNT; a++)
+                statistics_[c][a].Clear();
+    }
+
+    const RunningStatistics& Get(HodographChannel channel, Axis axis) const {
+        return statistics_[static_cast<int>(channel)][static_cast<int>(axis)];
+    }
+
+private:
+    void Push(HodographChannel channel, const Vec3& value, double time){
+        RunningStatistics* statistics = statistics_[static_cast<int>(channel)];
+        statistics[0].Push(value.x, time);
+        statistics[1].Push(value.y, time);
+        statistics[2].Push(value.z, time);
+    }
+
+    RunningStatistics statistics_[HODOGRAPH_CHANNEL_COUNT][AXIS_COUNT];
+};
+
+#endif //PROJECT_HODOGRAPH_STATISTICS_H
@@ -0,0 +1,103 @@
+#ifndef PROJECT_PHASE_DENSITY_H
+#define PROJECT_PHASE_DENSITY_H
+
+#include <containers/min_max_pyramid.h>
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Cell columns [begin, end) of cell rows [row, row + rows) with the same
+ * intensity level, drawn as a single rectangle.
+ */
+struct DensityRun{
+    int row;
+    int rows;
+    int begin;
+    int end;
+    int level;
+};
+
+/**
+ * Phase portrait (x, v) accumulated into a fixed grid of sample counts.
+ *
+ * Push costs O(1) and the grid never grows, so drawing it costs the same
+ * after a second or after a day. The bounds adapt to the data: a sample
+ * outside doubles the span of that axis and merges neighbouring cells,
+ * which happens O(log(range / initial span)) times per run.
+ */
+class PhaseDensity{
+public:
+    static const int DEFAULT_RESOLUTION = 128;
+    static const int DEFAULT_LEVELS = 16;
+    static const int MAX_LEVELS = 64;
+    static const std::size_t DEFAULT_MAX_RUNS = 4096;
+
+    /**
+     * Resolutions are rounded up to even numbers.
+     */
+    PhaseDensity(int width = DEFAULT_RESOLUTION,
+                 int height = DEFAULT_RESOLUTION);
+    ~PhaseDensity();
+
+    int width() const {return width_;}
+    int height() const {return height_;}
+
+    /**
+     * Samples pushed since the last Clear, NaN samples are skipped.
+     */
+    std::size_t size() const {return size_;}
+
+    /**
+     * Counts in row major order, row 0 holds the lowest velocities.
+     */
+    const std::vector<float>& cells() const {return cells_;}
+    float count(int column, int row) const {
+        return cells_[row * width_ + column];}
+    float max_count() const {return max_count_;}
+
+    /**
+     * Covered ranges, only valid if size() > 0.
+     */
+    MinMax x_range() const {return MinMax{x_min_, x_min_ + x_span_};}
+    MinMax v_range() const {return MinMax{v_min_, v_min_ + v_span_};}
+
+    /**
+     * Non-empty cells as horizontal runs of equal intensity. The
+     * logarithmic intensity log(1 + count) / log(1 + max_count()) is
+     * quantized to levels steps (at most MAX_LEVELS), level 1 is the
+     * faintest non-empty one.
+     *
+     * A smooth portrait needs far fewer runs than cells. If there are
+     * still more than max_runs, square blocks of 2, 4, ... cells rated by
+     * their mean count take the place of cells until they fit. runs keeps
+     * its capacity between calls.
+     */
+    void Runs(int levels, std::size_t max_runs,
+              std::vector<DensityRun>& runs) const;
+
+    void Push(float x, float v);
+    void Clear();
+
+private:
+    void Start(float x, float v);
+    void ExpandColumns(bool down);
+    void ExpandRows(bool down);
+    void UpdateMaxCount();
+    void BlockRuns(int levels, int block,
+                   std::vector<DensityRun>& runs) const;
+
+    int width_;
+    int height_;
+    std::vector<float> cells_;
+    std::vector<float> scratch_;
+    float max_count_;
+    std::size_t size_;
+
+    float x_min_;
+    float x_span_;
+    float v_min_;
+    float v_span_;
+};
+
+#endif //PROJECT_PHASE_DENSITY_H
@@ -0,0 +1,63 @@
+#ifndef PROJECT_RUNNING_STATISTICS_H
+#define PROJECT_RUNNING_STATISTICS_H
+
+#include <cmath>
+
+/**
+ * Streaming statistics of a value series, O(1) per value and independent
+ * of any stored history. Mean and variance use Welford's update, which
+ * stays accurate over long runs. NaN values are only counted as invalid.
+ */
+struct RunningStatistics{
+    unsigned long long count = 0;
+    unsigned long long invalid = 0;
+
+    double mean = 0;
+    /**
+     * Sum of squared differences from the mean.
+     */
+    double m2 = 0;
+    double sum_sqr = 0;
+
+    float min = 0;
+    float max = 0;
+
+    /**
+     * Largest |value| and the time it occurred at.
+     */
+    float peak = 0;
+    double peak_time = 0;
+
+    void Push(float value, double time){
+        if(std::isnan(value)){
+            invalid++;
+            return;
+        }
+        if(count == 0){
+            min = value;
+            max = value;
+        }
+        count++;
+
+        double delta = value - mean;
+        mean += delta / count;
+        m2 += delta * (value - mean);
+        sum_sqr += (double)value * value;
+
+        if(value < min)
+            min = value;
+        if(value > max)
+            max = value;
+        if(std::fabs(value) > peak){
+            peak = std::fabs(value);
+            peak_time = time;
+        }
+    }
+
+    void Clear(){*this = RunningStatistics();}
+
+    double variance() const {return count > 0 ? m2 / count : 0;}
+    double rms() const {return count > 0 ? std::sqrt(sum_sqr / count) : 0;}
+};
+
+#endif //PROJECT_RUNNING_STATISTICS_H
@@ -0,0 +1,27 @@
+#ifndef PROJECT_SUMMARY_STATISTICS_H
+#define PROJECT_SUMMARY_STATISTICS_H
+
+#include <cstddef>
+#include <vector>
+
+struct SummaryStatistics{
+    float mean = 0;
+    float variance = 0;
+    float p05 = 0;
+    float p50 = 0;
+    float p95 = 0;
+    /**
+     * Number of NaN values, excluded from all other fields.
+     */
+    std::size_t invalid = 0;
+};
+
+/**
+ * Mean, variance and percentiles of values[0, count).
+ * scratch is resized to count on first use and reused afterwards.
+ */
+SummaryStatistics ComputeSummaryStatistics(const float* values,
+                                           std::size_t count,
+                                           std::vector<float>& scratch);
+
+#endif //PROJECT_SUMMARY_STATISTICS_H
@@ -0,0 +1,43 @@
+#ifndef PROJECT_PARAMETER_GRID_H
+#define PROJECT_PARAMETER_GRID_H
+
+#include <kinematics/hodograph_parameters.h>
+
+#include <cstddef>
+
+/**
+ * count evenly spaced values from min to max, both included.
+ */
+struct SweepRange{
+    float min;
+    float max;
+    int count;
+
+    SweepRange(float value = 0) : min(value), max(value), count(1){}
+    SweepRange(float min, float max, int count) :
+            min(min), max(max), count(count){}
+
+    float Value(int i) const {
+        if(count <= 1)
+            return min;
+        return min + (max - min) * i / (count - 1);
+    }
+};
+
+/**
+ * Cartesian product of the (angular velocity, radius, line length, error)
+ * ranges. Error varies fastest.
+ */
+struct ParameterGrid{
+    SweepRange angular_velocity;
+    SweepRange radius;
+    SweepRange line_length;
+    SweepRange error;
+
+    ParameterGrid(const HodographParameters& parameters = HodographParameters());
+
+    std::size_t size() const;
+    HodographParameters At(std::size_t index) const;
+};
+
+#endif //PROJECT_PARAMETER_GRID_H
@@ -0,0 +1,81 @@
+#ifndef PROJECT_PARAMETER_SWEEP_H
+#define PROJECT_PARAMETER_SWEEP_H
+
+#include <sweep/parameter_grid.h>
+#include <kinematics/crank_slider_analytic.h>
+#include <filters/derivative_filter.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+class WorkStealingPool;
+
+struct SweepResult{
+    std::size_t index;
+    HodographParameters parameters;
+
+    /**
+     * False when L < r, the rod cannot reach the slider axis for every
+     * crank angle. Such configurations are not simulated.
+     */
+    bool buildable;
+    /**
+     * Steps that produced NaN because the noisy rod was too short.
+     */
+    long long invalid_steps;
+
+    float peak_acceleration;
+    float rms_acceleration;
+    float min_velocity;
+    float max_velocity;
+};
+
+/**
+ * Simulates every configuration of a ParameterGrid and reports summary
+ * metrics. Samples are skipped until HodographKinematics::sample_valid(),
+ * finite differences and filters are not defined before their history is
+ * filled.
+ *
+ * Configuration i draws its noise from stream i of the seed, so results do
+ * not depend on the thread count or the order jobs are stolen in.
+ */
+class ParameterSweep{
+public:
+    typedef std::function<void(const SweepResult&)> ResultCallback;
+
+    ParameterSweep(const ParameterGrid& grid,
+                   long long steps, float time_delta, uint64_t seed = 0);
+    ~ParameterSweep();
+
+    /**
+     * Splits the grid into jobs of chunk_size configurations and blocks
+     * until all are done. callback is called once per configuration in
+     * completion order, never concurrently.
+     */
+    void Run(WorkStealingPool& pool, ResultCallback callback,
+             std::size_t chunk_size = 16);
+
+    SweepResult Evaluate(std::size_t index) const;
+
+    DerivativeMethod derivative_method() const {return derivative_method_;}
+    void derivative_method(DerivativeMethod value){
+        derivative_method_ = value;}
+
+    /**
+     * Smoothing of the finite differences, ignored by the analytic method.
+     */
+    const FilterSettings& filter_settings() const {return filter_settings_;}
+    void filter_settings(const FilterSettings& value){
+        filter_settings_ = value;}
+
+private:
+    ParameterGrid grid_;
+    long long steps_;
+    float time_delta_;
+    uint64_t seed_;
+    DerivativeMethod derivative_method_;
+    FilterSettings filter_settings_;
+};
+
+#endif //PROJECT_PARAMETER_SWEEP_H
@@ -0,0 +1,59 @@
+#ifndef PROJECT_TELEMETRY_FORMAT_H
+#define PROJECT_TELEMETRY_FORMAT_H
+
+#include <trace/trace_format.h>
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * POSIX shared memory object: one TelemetryHeader followed by capacity
+ * TelemetrySlots, a ring of the latest TraceRecords.
+ *
+ * Record i lives in slot i % capacity. Each slot is a seqlock, the writer
+ * sets its sequence to 2i + 1 before and to 2i + 2 after copying the
+ * record. A reader that sees 2i + 2 both before and after its own copy
+ * got record i intact, any other value means the record is not written
+ * yet or was overwritten meanwhile. Readers map the object read-only and
+ * the writer never looks at them.
+ */
+const char TELEMETRY_MAGIC[8] = {'H', 'O', 'D', 'O', 'S', 'H', 'M', '\0'};
+const uint32_t TELEMETRY_VERSION = 1;
+const char TELEMETRY_DEFAULT_NAME[] = "/hodograph";
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+              "Shared memory needs address-free 64 bit atomics");
+
+struct TelemetryHeader{
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t capacity;
+
+    /**
+     * Records published so far, the next one gets this index.
+     */
+    std::atomic<uint64_t> published;
+
+    /**
+     * Set when the writer is done, the object is unlinked at the same time.
+     */
+    std::atomic<uint64_t> closed;
+
+    uint8_t reserved[24];
+};
+
+struct TelemetrySlot{
+    std::atomic<uint64_t> sequence;
+    uint64_t reserved;
+    TraceRecord record;
+};
+
+static_assert(sizeof(TelemetryHeader) == 64, "TelemetryHeader layout changed");
+static_assert(sizeof(TelemetrySlot) == 80, "TelemetrySlot layout changed");
+
+inline std::size_t TelemetrySize(uint64_t capacity){
+    return sizeof(TelemetryHeader) + capacity * sizeof(TelemetrySlot);
+}
+
+#endif //PROJECT_TELEMETRY_FORMAT_H
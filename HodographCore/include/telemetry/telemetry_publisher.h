@@ -0,0 +1,58 @@
+#ifndef PROJECT_TELEMETRY_PUBLISHER_H
+#define PROJECT_TELEMETRY_PUBLISHER_H
+
+#include <telemetry/telemetry_format.h>
+
+#include <string>
+
+/**
+ * Writer side of the telemetry ring, see telemetry_format.h. Publish copies
+ * one record into the mapping and never waits, however many readers are
+ * attached or how slow they are.
+ */
+class TelemetryPublisher{
+public:
+    static const std::size_t DEFAULT_CAPACITY = 1 << 16;
+
+    TelemetryPublisher();
+    ~TelemetryPublisher();
+
+    /**
+     * Creates the shared memory object name, replacing a stale one.
+     * capacity is rounded up to a power of two. Returns false and sets
+     * error() on failure.
+     */
+    bool Open(const std::string& name,
+              std::size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * Marks the ring closed and unlinks it, attached readers keep their
+     * mapping.
+     */
+    void Close();
+
+    bool is_open(){return header_ != nullptr;}
+    const std::string& name(){return name_;}
+
+    /**
+     * Called by a single writer thread.
+     */
+    void Publish(const TraceRecord& record);
+
+    unsigned long long published(){return published_;}
+    const std::string& error(){return error_;}
+
+private:
+    void SetError(const std::string& message);
+
+    TelemetryHeader* header_;
+    TelemetrySlot* slots_;
+    std::size_t length_;
+    uint64_t mask_;
+    uint64_t published_;
+
+    std::string name_;
+    std::string error_;
+};
+
+#endif //PROJECT_TELEMETRY_PUBLISHER_H
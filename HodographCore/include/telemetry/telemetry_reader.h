@@ -0,0 +1,66 @@
+#ifndef PROJECT_TELEMETRY_READER_H
+#define PROJECT_TELEMETRY_READER_H
+
+#include <telemetry/telemetry_format.h>
+
+#include <string>
+
+enum class TelemetryRead{
+    OK, NOT_PUBLISHED, OVERWRITTEN
+};
+
+/**
+ * Reader side of the telemetry ring, any number of processes may attach
+ * to the same publisher. The mapping is read-only, a reader cannot slow
+ * the writer down, it can only fall behind and lose records.
+ */
+class TelemetryReader{
+public:
+    TelemetryReader();
+    ~TelemetryReader();
+
+    /**
+     * Returns false and sets error() if name does not exist or is not a
+     * telemetry ring. The cursor starts at the newest record.
+     */
+    bool Open(const std::string& name);
+    void Close();
+
+    bool is_open(){return header_ != nullptr;}
+    bool is_closed(){
+        return header_->closed.load(std::memory_order_acquire) != 0;}
+
+    uint64_t capacity(){return header_->capacity;}
+    uint64_t published(){
+        return header_->published.load(std::memory_order_acquire);}
+
+    /**
+     * Copies record index if it is still in the ring.
+     */
+    TelemetryRead Read(uint64_t index, TraceRecord& record);
+
+    /**
+     * Reads up to count records from the cursor on and advances it.
+     * Records overwritten before they were read are skipped and counted
+     * in lost(). indices may be null.
+     */
+    std::size_t ReadNext(TraceRecord* records, uint64_t* indices,
+                         std::size_t count);
+
+    uint64_t cursor(){return cursor_;}
+    void cursor(uint64_t value){cursor_ = value;}
+    unsigned long long lost(){return lost_;}
+
+    const std::string& error(){return error_;}
+
+private:
+    const TelemetryHeader* header_;
+    const TelemetrySlot* slots_;
+    std::size_t length_;
+
+    uint64_t cursor_;
+    unsigned long long lost_;
+    std::string error_;
+};
+
+#endif //PROJECT_TELEMETRY_READER_H
@@ -0,0 +1,216 @@
+#ifndef PROJECT_KINEMATICS_THREAD_H
+#define PROJECT_KINEMATICS_THREAD_H
+
+#include <kinematics/hodograph_kinematics.h>
+#include <linkage/linkage_kinematics.h>
+#include <containers/spsc_queue.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+/**
+ * Everything the GUI may change while the kinematics thread is running.
+ */
+struct HodographSettings{
+    HodographParameters parameters;
+    DerivativeMethod derivative_method = DerivativeMethod::FINITE_DIFFERENCE;
+    bool diagnostics_enabled = false;
+    bool sensitivity_enabled = false;
+    FilterSettings filter;
+    /**
+     * Anything but CRANK_SLIDER runs LinkageKinematics, which ignores the
+     * derivative method, filter, diagnostics and sensitivities.
+     */
+    MechanismSettings mechanism;
+    /**
+     * Seed of the rod length noise, changing it restarts the noise stream.
+     */
+    uint64_t seed = 0;
+};
+
+inline bool operator==(const HodographSettings& a,
+                       const HodographSettings& b){
+    return a.parameters == b.parameters
+           && a.derivative_method == b.derivative_method
+           && a.diagnostics_enabled == b.diagnostics_enabled
+           && a.sensitivity_enabled == b.sensitivity_enabled
+           && a.filter == b.filter
+           && a.mechanism == b.mechanism
+           && a.seed == b.seed;
+}
+
+inline bool operator!=(const HodographSettings& a,
+                       const HodographSettings& b){
+    return !(a == b);
+}
+
+/**
+ * State of one simulation step, published to the GUI.
+ */
+struct HodographFrame{
+    /**
+     * Number of resets the kinematics had seen, see KinematicsThread::Reset.
+     */
+    uint32_t generation;
+    long long step;
+    double time;
+    /**
+     * Simulated time since the previous frame, fast_forward steps.
+     */
+    double frame_interval;
+    /**
+     * Crank angular velocity the frame was simulated with.
+     */
+    float angular_velocity;
+    float alpha;
+    float line_error_length;
+    Vec3 position0;
+    /**
+     * Slider joint at the crank angle of position0. sample.position lags
+     * behind it while a derivative filter is enabled.
+     */
+    Vec3 position1;
+    HodographSample sample;
+    /**
+     * See HodographKinematics::sample_valid, linkage samples are exact.
+     */
+    bool sample_valid;
+    HodographSample derivative_difference;
+    HodographSensitivity sensitivity;
+    /**
+     * Linkage solver result, OK with 0 iterations for the closed form.
+     */
+    LinkageStatus linkage_status;
+    int linkage_iterations;
+};
+
+/**
+ * Runs HodographKinematics, or LinkageKinematics for other mechanisms, on
+ * its own thread at a fixed rate, time_delta = 1 / rate.
+ *
+ * Settings travel to the thread and frames travel back through two
+ * lock-free single-producer/single-consumer queues. The thread never
+ * waits for the GUI, frames that do not fit into the queue are dropped
+ * and counted. Statistics, which see every step, are published as a
+ * snapshot instead.
+ */
+class KinematicsThread{
+public:
+    static const std::size_t DEFAULT_QUEUE_CAPACITY = 16384;
+
+    KinematicsThread(double rate = 1000,
+                     std::size_t queue_capacity = DEFAULT_QUEUE_CAPACITY);
+    ~KinematicsThread();
+
+    void Start();
+    void Stop();
+
+    bool IsRunning(){return running_;}
+    void SetRunning(bool running){running_ = running;}
+
+    double rate(){return rate_;}
+    void SetRate(double rate);
+
+    /**
+     * Steps per tick, only the last one is published as a frame. The extra
+     * steps go through HodographKinematics::Step. 1 runs in real time.
+     */
+    int fast_forward(){return fast_forward_;}
+    void SetFastForward(int factor);
+
+    /**
+     * Simulated seconds between two published frames, fast_forward / rate.
+     */
+    double frame_interval(){return fast_forward_ / rate_;}
+
+    /**
+     * Restarts the kinematics from alpha = 0 on the next tick. Frames,
+     * cycles and statistics still queued from before are dropped by the
+     * Pop functions.
+     */
+    void Reset(){resets_++;}
+    /**
+     * Clears the statistics on the next tick, the kinematics go on.
+     */
+    void ResetStatistics(){statistics_resets_++;}
+
+    /**
+     * Called by the GUI thread only.
+     */
+    bool PushSettings(const HodographSettings& settings);
+    bool PopFrame(HodographFrame& frame);
+    /**
+     * Revolutions finished by the kinematics, see CycleAnalyzer.
+     */
+    bool PopCycle(CycleRecord& cycle);
+    /**
+     * Statistics of every valid step since the last reset, fast-forwarded
+     * ones included, as of the last tick. False until the thread has
+     * published a snapshot after the last reset.
+     */
+    bool ReadStatistics(HodographStatistics& statistics);
+
+    unsigned long long dropped_frames(){return dropped_frames_;}
+    long long steps(){return steps_;}
+
+private:
+    /**
+     * CycleRecord tagged like HodographFrame::generation.
+     */
+    struct QueuedCycle{
+        uint32_t generation;
+        CycleRecord record;
+    };
+
+    void Run();
+    void Step(float time_delta, int count);
+    void StepLinkage(float time_delta, int count, HodographFrame& frame);
+    void ApplySettings(const HodographSettings& settings);
+    void PushCycles();
+    void PublishStatistics();
+
+    HodographKinematics kinematics_;
+    LinkageKinematics linkage_;
+    /**
+     * LinkageKinematics keeps none of its own.
+     */
+    HodographStatistics linkage_statistics_;
+    HodographSettings settings_;
+    double time_;
+
+    SpscQueue<HodographSettings> settings_queue_;
+    SpscQueue<HodographFrame> frame_queue_;
+    SpscQueue<QueuedCycle> cycle_queue_;
+    uint32_t pushed_cycles_;
+    /**
+     * Resets applied by the kinematics thread, owned by it.
+     */
+    uint32_t generation_;
+    uint32_t statistics_generation_;
+
+    /**
+     * Latest statistics snapshot. The kinematics thread only try_locks,
+     * it skips a publish rather than wait for the GUI.
+     */
+    std::mutex statistics_mutex_;
+    HodographStatistics published_statistics_;
+    uint32_t published_generation_;
+    uint32_t published_statistics_generation_;
+
+    std::thread thread_;
+    std::atomic<bool> stop_;
+    std::atomic<bool> running_;
+    /**
+     * Resets requested by the GUI.
+     */
+    std::atomic<uint32_t> resets_;
+    std::atomic<uint32_t> statistics_resets_;
+    std::atomic<double> rate_;
+    std::atomic<int> fast_forward_;
+
+    std::atomic<unsigned long long> dropped_frames_;
+    std::atomic<long long> steps_;
+};
+
+#endif //PROJECT_KINEMATICS_THREAD_H
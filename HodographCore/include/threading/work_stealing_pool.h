@@ -0,0 +1,60 @@
+#ifndef PROJECT_WORK_STEALING_POOL_H
+#define PROJECT_WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of worker threads, each with its own task deque.
+ * A worker pops its newest task first and steals the oldest task of
+ * another worker once its own deque runs dry.
+ */
+class WorkStealingPool{
+public:
+    typedef std::function<void()> Task;
+
+    /**
+     * thread_count 0 uses std::thread::hardware_concurrency().
+     */
+    WorkStealingPool(unsigned int thread_count = 0);
+    ~WorkStealingPool();
+
+    unsigned int thread_count(){return (unsigned int)workers_.size();}
+
+    void Submit(Task task);
+
+    /**
+     * Blocks until every submitted task has finished.
+     */
+    void Wait();
+
+private:
+    struct WorkerQueue{
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void Work(unsigned int index);
+    bool Pop(unsigned int index, Task& task);
+    bool Steal(unsigned int index, Task& task);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable task_condition_;
+    std::condition_variable done_condition_;
+
+    std::atomic<std::size_t> queued_;
+    std::size_t pending_;
+    unsigned int next_queue_;
+    bool stop_;
+};
+
+#endif //PROJECT_WORK_STEALING_POOL_H
@@ -0,0 +1,57 @@
+#ifndef PROJECT_TRACE_FORMAT_H
+#define PROJECT_TRACE_FORMAT_H
+
+#include <kinematics/hodograph_parameters.h>
+#include <kinematics/hodograph_cache.h>
+
+#include <cstdint>
+
+/**
+ * Binary trace: one TraceHeader followed by TraceRecords, appended in step
+ * order. Native byte order, the file is meant to be mapped on the machine
+ * family that wrote it.
+ */
+const char TRACE_MAGIC[8] = {'H', 'O', 'D', 'O', 'T', 'R', 'C', '\0'};
+const uint32_t TRACE_VERSION = 1;
+
+struct TraceHeader{
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+
+    HodographParameters parameters;
+    uint64_t seed;
+
+    /**
+     * Records known to be complete. Rewritten while recording, readers
+     * fall back to the file size if the writer did not finish.
+     */
+    uint64_t record_count;
+
+    uint8_t reserved[24];
+};
+
+struct TraceRecord{
+    double time;
+    float alpha;
+    float line_error_length;
+    Vec3 position0;
+    Vec3 position;
+    Vec3 velocity;
+    Vec3 acceleration;
+};
+
+static_assert(sizeof(TraceHeader) == 72, "TraceHeader layout changed");
+static_assert(sizeof(TraceRecord) == 64, "TraceRecord layout changed");
+
+TraceHeader CreateTraceHeader(const HodographParameters& parameters,
+                              uint64_t seed);
+
+TraceRecord CreateTraceRecord(double time, float alpha,
+                              float line_error_length,
+                              const Vec3& position0,
+                              const HodographSample& sample);
+
+HodographSample GetTraceSample(const TraceRecord& record);
+
+#endif //PROJECT_TRACE_FORMAT_H
@@ -0,0 +1,42 @@
+#ifndef PROJECT_TRACE_READER_H
+#define PROJECT_TRACE_READER_H
+
+#include <trace/trace_format.h>
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Read-only memory mapping of a trace file. records() points straight
+ * into the mapping, nothing is copied.
+ */
+class TraceReader{
+public:
+    TraceReader();
+    ~TraceReader();
+
+    /**
+     * Returns false and sets error() if the file cannot be mapped or is
+     * not a trace.
+     */
+    bool Open(const std::string& path);
+    void Close();
+
+    bool is_open(){return data_ != nullptr;}
+
+    const TraceHeader& header(){return *(const TraceHeader*)data_;}
+    const TraceRecord* records(){
+        return (const TraceRecord*)((const char*)data_ + sizeof(TraceHeader));
+    }
+    std::size_t size(){return size_;}
+
+    const std::string& error(){return error_;}
+
+private:
+    void* data_;
+    std::size_t length_;
+    std::size_t size_;
+    std::string error_;
+};
+
+#endif //PROJECT_TRACE_READER_H
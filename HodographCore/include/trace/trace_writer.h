@@ -0,0 +1,75 @@
+#ifndef PROJECT_TRACE_WRITER_H
+#define PROJECT_TRACE_WRITER_H
+
+#include <trace/trace_format.h>
+#include <containers/spsc_queue.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * Appends TraceRecords to a trace file from a background thread.
+ * Append only pushes into a lock-free queue, so the producer never waits
+ * for the disk. Records that do not fit into the queue are dropped and
+ * counted.
+ */
+class TraceWriter{
+public:
+    static const std::size_t DEFAULT_QUEUE_CAPACITY = 1 << 16;
+
+    TraceWriter(std::size_t queue_capacity = DEFAULT_QUEUE_CAPACITY);
+    ~TraceWriter();
+
+    /**
+     * Truncates path and writes the header. Returns false and sets
+     * error() if the file cannot be created.
+     */
+    bool Open(const std::string& path, const TraceHeader& header);
+
+    /**
+     * Writes everything still queued and the final header.
+     */
+    void Close();
+
+    bool is_open(){return fd_ >= 0;}
+
+    /**
+     * Called by a single producer thread.
+     */
+    bool Append(const TraceRecord& record);
+
+    /**
+     * Waits for space instead of dropping, for offline runs where the
+     * producer may outpace the disk. Returns false if the writer is not
+     * open.
+     */
+    bool AppendBlocking(const TraceRecord& record);
+
+    unsigned long long written(){return written_;}
+    unsigned long long dropped(){return dropped_;}
+    /**
+     * Set by Open or by the background thread, safe to poll every frame.
+     */
+    std::string error();
+
+private:
+    void Run();
+    bool Flush(const TraceRecord* records, std::size_t count);
+    void SetError(const std::string& message);
+
+    int fd_;
+    TraceHeader header_;
+    SpscQueue<TraceRecord> queue_;
+
+    std::thread thread_;
+    std::atomic<bool> stop_;
+
+    std::atomic<unsigned long long> written_;
+    std::atomic<unsigned long long> dropped_;
+    std::mutex error_mutex_;
+    std::string error_;
+};
+
+#endif //PROJECT_TRACE_WRITER_H
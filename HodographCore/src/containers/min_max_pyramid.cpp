@@ -0,0 +1,117 @@
+#include "containers/min_max_pyramid.h"
+
+#include <algorithm>
+#include <cfloat>
+
+namespace {
+
+MinMax EmptyMinMax(){
+    MinMax min_max;
+    min_max.min = FLT_MAX;
+    min_max.max = -FLT_MAX;
+    return min_max;
+}
+
+void Merge(MinMax& a, const MinMax& b){
+    a.min = std::min(a.min, b.min);
+    a.max = std::max(a.max, b.max);
+}
+
+}
+
+MinMaxPyramid::MinMaxPyramid(std::size_t capacity) :
+        capacity_(0),
+        count_(0){
+    SetCapacity(capacity);
+}
+
+MinMaxPyramid::~MinMaxPyramid(){}
+
+void MinMaxPyramid::SetCapacity(std::size_t capacity){
+    capacity_ = capacity;
+    levels_.clear();
+
+    // Level k keeps every block that can overlap the retained window.
+    levels_.push_back(std::vector<MinMax>());
+    for(std::size_t block = 2; block < capacity_ * 2; block <<= 1){
+        std::size_t blocks = (capacity_ + block - 1) / block + 1;
+        levels_.push_back(std::vector<MinMax>(blocks, EmptyMinMax()));
+    }
+    Clear();
+}
+
+void MinMaxPyramid::Clear(){
+    count_ = 0;
+}
+
+void MinMaxPyramid::Push(float value){
+    for(std::size_t k = 1; k < levels_.size(); k++){
+        std::vector<MinMax>& level = levels_[k];
+        MinMax& min_max = level[(count_ >> k) % level.size()];
+        if((count_ & ((1ull << k) - 1)) == 0){
+            min_max.min = value;
+            min_max.max = value;
+        }else{
+            min_max.min = std::min(min_max.min, value);
+            min_max.max = std::max(min_max.max, value);
+        }
+    }
+    count_++;
+}
+
+std::size_t MinMaxPyramid::memory_bytes() const {
+    std::size_t bytes = levels_.capacity() * sizeof(std::vector<MinMax>);
+    for(const std::vector<MinMax>& level : levels_)
+        bytes += level.capacity() * sizeof(MinMax);
+    return bytes;
+}
+
+MinMax MinMaxPyramid::Range(const RingView<float>& raw,
+                            std::size_t begin, std::size_t end) const {
+    MinMax result = EmptyMinMax();
+    unsigned long long first = count_ - size();
+    unsigned long long b = first + begin;
+    unsigned long long e = first + std::min(end, size());
+    std::size_t top = levels_.size() - 1;
+
+    // Greedily take the largest aligned block that fits.
+    while(b < e){
+        std::size_t k = 0;
+        while(k < top && (b & ((2ull << k) - 1)) == 0
+              && b + (2ull << k) <= e)
+            k++;
+
+        if(k == 0){
+            float value = raw[(int)(b - first)];
+            result.min = std::min(result.min, value);
+            result.max = std::max(result.max, value);
+            b++;
+        }else{
+            const std::vector<MinMax>& level = levels_[k];
+            Merge(result, level[(b >> k) % level.size()]);
+            b += 1ull << k;
+        }
+    }
+    return result;
+}
+
+MinMax MinMaxPyramid::Resample(const RingView<float>& raw,
+                               std::size_t begin, std::size_t end,
+                               MinMax* columns, int width) const {
+    MinMax result = EmptyMinMax();
+    end = std::min(end, size());
+    if(begin >= end || width <= 0)
+        return result;
+
+    std::size_t length = end - begin;
+    for(int i = 0; i < width; i++){
+        std::size_t column_begin = begin + length * i / width;
+        std::size_t column_end = begin + length * (i + 1) / width;
+        if(column_end <= column_begin)
+            column_end = column_begin + 1;
+
+        columns[i] = Range(raw, column_begin, column_end);
+        Merge(result, columns[i]);
+    }
+    return result;
+}
@@ -0,0 +1,232 @@
+#include "filters/derivative_filter.h"
+
+#include <algorithm>
+#include <cmath>
+
+const int FilterSettings::MAX_HALF_WINDOW;
+const int FilterSettings::MAX_ORDER;
+
+namespace {
+
+/**
+ * Fraction of the EXPONENTIAL start transient left when it is settled.
+ */
+const double EXPONENTIAL_SETTLE = 1e-3;
+
+FilterSettings Sanitize(const FilterSettings& settings){
+    FilterSettings result = settings;
+    result.half_window = std::max(1, std::min(
+            result.half_window, FilterSettings::MAX_HALF_WINDOW));
+    result.order = std::max(2, std::min(
+            result.order, FilterSettings::MaxOrder(result.half_window)));
+    result.smoothing = std::max(0.01f, std::min(result.smoothing, 1.0f));
+    return result;
+}
+
+/**
+ * Kernels of position, velocity and acceleration, index j multiplies the
+ * sample j steps in the past.
+ */
+std::vector<std::vector<float>> SavitzkyGolayKernels(
+        const FilterSettings& settings, float time_delta){
+    int m = settings.half_window;
+    std::vector<std::vector<float>> kernels(3);
+    for(int d = 0; d < 3; d++){
+        std::vector<double> coefficients
+                = SavitzkyGolayCoefficients(m, settings.order, d);
+        double scale = std::pow((double)time_delta, -d);
+        kernels[d].resize(2 * m + 1);
+        for(int j = 0; j <= 2 * m; j++)
+            kernels[d][j] = (float)(coefficients[2 * m - j] * scale);
+    }
+    return kernels;
+}
+
+/**
+ * Box average convolved with the central differences, all three kernels
+ * are 2 * half_window + 3 samples long and share the same delay.
+ */
+std::vector<std::vector<float>> MovingAverageKernels(
+        const FilterSettings& settings, float time_delta){
+    int width = 2 * settings.half_window + 1;
+    float box = 1.0f / width;
+    float velocity = box / (2 * time_delta);
+    float acceleration = box / (time_delta * time_delta);
+
+    std::vector<std::vector<float>> kernels(
+            3, std::vector<float>(width + 2, 0));
+    for(int i = 0; i < width; i++){
+        kernels[0][i + 1] += box;
+
+        kernels[1][i] += velocity;
+        kernels[1][i + 2] -= velocity;
+
+        kernels[2][i] += acceleration;
+        kernels[2][i + 1] -= 2 * acceleration;
+        kernels[2][i + 2] += acceleration;
+    }
+    return kernels;
+}
+
+std::vector<std::vector<float>> CentralDifferenceKernels(float time_delta){
+    float velocity = 1.0f / (2 * time_delta);
+    float acceleration = 1.0f / (time_delta * time_delta);
+
+    std::vector<std::vector<float>> kernels(3);
+    kernels[0] = {0, 1, 0};
+    kernels[1] = {velocity, 0, -velocity};
+    kernels[2] = {acceleration, -2 * acceleration, acceleration};
+    return kernels;
+}
+
+}
+
+float FilterGroupDelay(const FilterSettings& settings){
+    FilterSettings sanitized = Sanitize(settings);
+    switch(sanitized.type){
+        case FilterType::SAVITZKY_GOLAY:
+            return (float)sanitized.half_window;
+        case FilterType::MOVING_AVERAGE:
+            return (float)sanitized.half_window + 1;
+        case FilterType::EXPONENTIAL:
+            return (1 - sanitized.smoothing) / sanitized.smoothing + 1;
+        default:
+            return 0;
+    }
+}
+
+std::vector<double> SavitzkyGolayCoefficients(int half_window, int order,
+                                              int derivative){
+    // The fit is expanded in polynomials orthonormal over the window
+    // points u = t / half_window, built by the three-term recurrence
+    // p[k + 1] = ((u - a[k]) p[k] - b[k] p[k - 1]) / b[k + 1].
+    // Unlike the normal equations of t^k, this stays well conditioned for
+    // any order below the number of points.
+    int size = 2 * half_window + 1;
+    std::vector<double> u(size);
+    for(int i = 0; i < size; i++)
+        u[i] = (double)(i - half_window) / half_window;
+
+    std::vector<double> previous(size, 0);
+    double constant = 1 / std::sqrt((double)size);
+    std::vector<double> current(size, constant);
+    std::vector<double> next(size);
+    // Derivatives 0 .. derivative of p[k - 1] and p[k] at u = 0.
+    std::vector<double> previous_center(derivative + 1, 0);
+    std::vector<double> current_center(derivative + 1, 0);
+    std::vector<double> next_center(derivative + 1);
+    current_center[0] = constant;
+    double b = 0;
+
+    std::vector<double> coefficients(size, 0);
+    for(int k = 0; k <= order; k++){
+        for(int i = 0; i < size; i++)
+            coefficients[i] += current_center[derivative] * current[i];
+        if(k == order)
+            break;
+
+        double a = 0;
+        for(int i = 0; i < size; i++)
+            a += u[i] * current[i] * current[i];
+        double norm = 0;
+        for(int i = 0; i < size; i++){
+            next[i] = (u[i] - a) * current[i] - b * previous[i];
+            norm += next[i] * next[i];
+        }
+        norm = std::sqrt(norm);
+        for(int i = 0; i < size; i++)
+            next[i] /= norm;
+        for(int d = 0; d <= derivative; d++){
+            double center = -a * current_center[d] - b * previous_center[d];
+            if(d > 0)
+                center += d * current_center[d - 1];
+            next_center[d] = center / norm;
+        }
+
+        previous.swap(current);
+        current.swap(next);
+        previous_center.swap(current_center);
+        current_center.swap(next_center);
+        b = norm;
+    }
+
+    // d/dt = d/du / half_window.
+    double scale = std::pow((double)half_window, -derivative);
+    for(int i = 0; i < size; i++)
+        coefficients[i] *= scale;
+    return coefficients;
+}
+
+DerivativeFilter::DerivativeFilter() :
+        primed_(false),
+        warm_up_(0),
+        pushed_(0),
+        time_delta_(0){}
+
+DerivativeFilter::~DerivativeFilter(){}
+
+void DerivativeFilter::Configure(const FilterSettings& settings,
+                                 float time_delta){
+    if(settings == settings_ && time_delta == time_delta_)
+        return;
+    settings_ = settings;
+    time_delta_ = time_delta;
+
+    FilterSettings sanitized = Sanitize(settings);
+    std::vector<std::vector<float>> kernels;
+    switch(sanitized.type){
+        case FilterType::SAVITZKY_GOLAY:
+            kernels = SavitzkyGolayKernels(sanitized, time_delta);
+            break;
+        case FilterType::MOVING_AVERAGE:
+            kernels = MovingAverageKernels(sanitized, time_delta);
+            break;
+        case FilterType::EXPONENTIAL:
+            kernels = CentralDifferenceKernels(time_delta);
+            break;
+        default:
+            break;
+    }
+    for(int axis = 0; axis < 3; axis++)
+        banks_[axis].SetKernels(kernels);
+    warm_up_ = kernels.empty() ? 0 : kernels[0].size() - 1;
+    if(sanitized.type == FilterType::EXPONENTIAL){
+        // The transient shrinks by 1 - smoothing per sample.
+        warm_up_ += (std::size_t)std::ceil(
+                std::log(EXPONENTIAL_SETTLE)
+                / std::log(1 - (double)sanitized.smoothing));
+    }
+    Clear();
+}
+
+HodographSample DerivativeFilter::Push(const Vec3& position){
+    Vec3 input = position;
+    if(settings_.type == FilterType::EXPONENTIAL){
+        if(!primed_)
+            smoothed_ = position;
+        float smoothing = Sanitize(settings_).smoothing;
+        smoothed_ = smoothed_ + (position - smoothed_) * smoothing;
+        input = smoothed_;
+    }
+    primed_ = true;
+    if(pushed_ <= warm_up_)
+        pushed_++;
+
+    float x[3], y[3], z[3];
+    banks_[0].Push(input.x, x);
+    banks_[1].Push(input.y, y);
+    banks_[2].Push(input.z, z);
+
+    HodographSample sample;
+    sample.position = Vec3(x[0], y[0], z[0]);
+    sample.velocity = Vec3(x[1], y[1], z[1]);
+    sample.acceleration = Vec3(x[2], y[2], z[2]);
+    return sample;
+}
+
+void DerivativeFilter::Clear(){
+    for(int axis = 0; axis < 3; axis++)
+        banks_[axis].Clear();
+    primed_ = false;
+    pushed_ = 0;
+}
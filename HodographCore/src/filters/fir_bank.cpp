@@ -0,0 +1,86 @@
+#include "filters/fir_bank.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/**
+ * Taps are padded to a multiple of the vector width, the padding
+ * multiplies the oldest samples by 0 and the dot product needs no tail.
+ */
+const std::size_t TAP_ALIGNMENT = 4;
+
+#if defined(__SSE2__)
+
+float Dot(const float* kernel, const float* window, std::size_t length){
+    __m128 sum = _mm_setzero_ps();
+    for(std::size_t i = 0; i < length; i += 4)
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(kernel + i),
+                                         _mm_loadu_ps(window + i)));
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, sum);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+#else
+
+float Dot(const float* kernel, const float* window, std::size_t length){
+    float sum = 0;
+    for(std::size_t i = 0; i < length; i++)
+        sum += kernel[i] * window[i];
+    return sum;
+}
+
+#endif
+
+}
+
+FirBank::FirBank() :
+        length_(0),
+        kernel_count_(0),
+        head_(0),
+        primed_(false){}
+
+FirBank::~FirBank(){}
+
+void FirBank::SetKernels(const std::vector<std::vector<float>>& kernels){
+    kernel_count_ = kernels.size();
+    std::size_t taps = kernels.empty() ? 0 : kernels[0].size();
+    length_ = (taps + TAP_ALIGNMENT - 1) / TAP_ALIGNMENT * TAP_ALIGNMENT;
+
+    kernels_.assign(kernel_count_ * length_, 0);
+    for(std::size_t k = 0; k < kernel_count_; k++){
+        for(std::size_t j = 0; j < taps && j < kernels[k].size(); j++)
+            kernels_[k * length_ + (length_ - 1 - j)] = kernels[k][j];
+    }
+    history_.assign(2 * length_, 0);
+    Clear();
+}
+
+void FirBank::Push(float x, float* outputs){
+    if(length_ == 0)
+        return;
+    if(!primed_){
+        std::fill(history_.begin(), history_.end(), x);
+        primed_ = true;
+    }
+
+    history_[head_] = x;
+    history_[head_ + length_] = x;
+    head_ = head_ + 1 == length_ ? 0 : head_ + 1;
+
+    // The oldest sample now sits at head_, the newest at head_ + length_ - 1.
+    const float* window = history_.data() + head_;
+    for(std::size_t k = 0; k < kernel_count_; k++)
+        outputs[k] = Dot(kernels_.data() + k * length_, window, length_);
+}
+
+void FirBank::Clear(){
+    head_ = 0;
+    primed_ = false;
+}
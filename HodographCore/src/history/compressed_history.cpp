@@ -0,0 +1,235 @@
+#include "history/compressed_history.h"
+
+#include <history/float_codec.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+const std::size_t CompressedHistory::CHUNK_SIZE;
+const std::size_t CompressedHistory::DEFAULT_QUEUE_CAPACITY;
+
+namespace {
+
+const std::size_t NO_CHUNK = (std::size_t)-1;
+
+MinMax EmptyMinMax(){
+    MinMax result;
+    result.min = INFINITY;
+    result.max = -INFINITY;
+    return result;
+}
+
+void Merge(MinMax& a, const MinMax& b){
+    a.min = std::min(a.min, b.min);
+    a.max = std::max(a.max, b.max);
+}
+
+int ColumnIndex(HodographChannel channel, Axis axis){
+    return static_cast<int>(channel) * AXIS_COUNT + static_cast<int>(axis);
+}
+
+void Compress(HistoryChunk& chunk){
+    for(int c = 0; c < HISTORY_COLUMN_COUNT; c++){
+        EncodeFloats(chunk.raw[c].data(), chunk.size, chunk.words[c]);
+        chunk.words[c].shrink_to_fit();
+    }
+    chunk.compressed.store(true, std::memory_order_release);
+}
+
+}
+
+CompressedHistory::CompressedHistory(std::size_t queue_capacity) :
+        size_(0),
+        released_(0),
+        queue_(queue_capacity),
+        stop_(false),
+        decoded_chunk_(NO_CHUNK),
+        decoded_column_(0){
+    Start();
+}
+
+CompressedHistory::~CompressedHistory(){
+    Stop();
+}
+
+void CompressedHistory::Push(const HodographSample& sample){
+    if(chunks_.empty() || chunks_.back()->size == CHUNK_SIZE){
+        std::unique_ptr<HistoryChunk> chunk(new HistoryChunk());
+        for(int c = 0; c < HISTORY_COLUMN_COUNT; c++)
+            chunk->raw[c].reserve(CHUNK_SIZE);
+        chunks_.push_back(std::move(chunk));
+    }
+
+    HistoryChunk& chunk = *chunks_.back();
+    const Vec3* channels[HODOGRAPH_CHANNEL_COUNT] = {
+            &sample.position, &sample.velocity, &sample.acceleration};
+    for(int channel = 0; channel < HODOGRAPH_CHANNEL_COUNT; channel++){
+        const Vec3& value = *channels[channel];
+        chunk.raw[channel * AXIS_COUNT + 0].push_back(value.x);
+        chunk.raw[channel * AXIS_COUNT + 1].push_back(value.y);
+        chunk.raw[channel * AXIS_COUNT + 2].push_back(value.z);
+    }
+    chunk.size++;
+    size_++;
+
+    if(chunk.size == CHUNK_SIZE)
+        Seal();
+    ReleaseRaw();
+}
+
+void CompressedHistory::Clear(){
+    Stop();
+    chunks_.clear();
+    size_ = 0;
+    released_ = 0;
+    decoded_chunk_ = NO_CHUNK;
+    Start();
+}
+
+void CompressedHistory::Flush(){
+    Stop();
+    ReleaseRaw();
+    Start();
+}
+
+void CompressedHistory::Read(HodographChannel channel, Axis axis,
+                             std::size_t begin, std::size_t end,
+                             float* values) const {
+    int column = ColumnIndex(channel, axis);
+    end = std::min(end, size_);
+    while(begin < end){
+        std::size_t chunk = begin / CHUNK_SIZE;
+        std::size_t first = begin - chunk * CHUNK_SIZE;
+        std::size_t count = std::min(end - begin, CHUNK_SIZE - first);
+
+        const float* data = Decode(chunk, column);
+        std::copy(data + first, data + first + count, values);
+        values += count;
+        begin += count;
+    }
+}
+
+MinMax CompressedHistory::Resample(HodographChannel channel, Axis axis,
+                                   std::size_t begin, std::size_t end,
+                                   MinMax* columns, int width) const {
+    MinMax result = EmptyMinMax();
+    end = std::min(end, size_);
+    if(begin >= end || width <= 0)
+        return result;
+
+    int column = ColumnIndex(channel, axis);
+    std::size_t length = end - begin;
+    for(int i = 0; i < width; i++){
+        std::size_t column_begin = begin + length * i / width;
+        std::size_t column_end = begin + length * (i + 1) / width;
+        if(column_end <= column_begin)
+            column_end = column_begin + 1;
+
+        columns[i] = Range(column, column_begin, column_end);
+        Merge(result, columns[i]);
+    }
+    return result;
+}
+
+std::size_t CompressedHistory::memory_bytes() const {
+    std::size_t bytes = chunks_.capacity() * sizeof(chunks_[0]);
+    for(std::size_t i = 0; i < chunks_.size(); i++){
+        const HistoryChunk& chunk = *chunks_[i];
+        bytes += sizeof(HistoryChunk);
+        bool compressed = chunk.compressed.load(std::memory_order_acquire);
+        for(int c = 0; c < HISTORY_COLUMN_COUNT; c++){
+            bytes += chunk.raw[c].capacity() * sizeof(float);
+            if(compressed)
+                bytes += chunk.words[c].capacity() * sizeof(uint64_t);
+        }
+    }
+    return bytes + decoded_.capacity() * sizeof(float);
+}
+
+std::size_t CompressedHistory::pending_chunks() const {
+    return queue_.size();
+}
+
+void CompressedHistory::Run(){
+    while(true){
+        bool stopping = stop_;
+        HistoryChunk* chunk;
+        while(queue_.TryPop(chunk))
+            Compress(*chunk);
+        if(stopping)
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void CompressedHistory::Seal(){
+    HistoryChunk& chunk = *chunks_.back();
+    for(int c = 0; c < HISTORY_COLUMN_COUNT; c++){
+        const std::vector<float>& raw = chunk.raw[c];
+        auto range = std::minmax_element(raw.begin(), raw.end());
+        chunk.ranges[c] = MinMax{*range.first, *range.second};
+    }
+
+    // Never drop history, compress here when the thread falls behind.
+    if(!queue_.TryPush(&chunk))
+        Compress(chunk);
+}
+
+void CompressedHistory::ReleaseRaw(){
+    while(released_ < chunks_.size()){
+        HistoryChunk& chunk = *chunks_[released_];
+        if(!chunk.compressed.load(std::memory_order_acquire))
+            break;
+        for(int c = 0; c < HISTORY_COLUMN_COUNT; c++)
+            std::vector<float>().swap(chunk.raw[c]);
+        released_++;
+    }
+}
+
+void CompressedHistory::Start(){
+    stop_ = false;
+    thread_ = std::thread(&CompressedHistory::Run, this);
+}
+
+void CompressedHistory::Stop(){
+    stop_ = true;
+    if(thread_.joinable())
+        thread_.join();
+}
+
+const float* CompressedHistory::Decode(std::size_t chunk, int column) const {
+    const HistoryChunk& source = *chunks_[chunk];
+    if(!source.raw[column].empty())
+        return source.raw[column].data();
+
+    if(decoded_chunk_ != chunk || decoded_column_ != column){
+        decoded_.resize(source.size);
+        DecodeFloats(source.words[column].data(), source.size,
+                     decoded_.data());
+        decoded_chunk_ = chunk;
+        decoded_column_ = column;
+    }
+    return decoded_.data();
+}
+
+MinMax CompressedHistory::Range(int column, std::size_t begin,
+                                std::size_t end) const {
+    MinMax result = EmptyMinMax();
+    while(begin < end){
+        std::size_t chunk = begin / CHUNK_SIZE;
+        std::size_t first = begin - chunk * CHUNK_SIZE;
+        std::size_t count = std::min(end - begin, CHUNK_SIZE - first);
+
+        if(count == CHUNK_SIZE){
+            Merge(result, chunks_[chunk]->ranges[column]);
+        }else{
+            const float* data = Decode(chunk, column);
+            auto range = std::minmax_element(data + first,
+                                             data + first + count);
+            Merge(result, MinMax{*range.first, *range.second});
+        }
+        begin += count;
+    }
+    return result;
+}
@@ -0,0 +1,336 @@
+#include "history/float_codec.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+/**
+ * Prefix codes of the zig-zag residual. Bucket k covers
+ * [base, base + 2^payload_bits), the last one stores the raw pattern.
+ */
+struct ResidualBucket{
+    int prefix_bits;
+    uint64_t prefix;
+    int payload_bits;
+    uint64_t base;
+};
+
+const int BUCKET_COUNT = 6;
+const int RAW_BUCKET = BUCKET_COUNT - 1;
+const ResidualBucket BUCKETS[BUCKET_COUNT] = {
+        {1, 0x00, 0, 0},
+        {2, 0x02, 2, 1},
+        {3, 0x06, 5, 5},
+        {4, 0x0E, 12, 37},
+        {5, 0x1E, 20, 4133},
+        {5, 0x1F, 32, 0}
+};
+
+/**
+ * Every series starts with its predictor: 0, 1 or 2 is the extrapolation
+ * order, CONSTANT stores the first value only and RAW the plain patterns
+ * of series that are noise down to the last bits. DICTIONARY stores the
+ * distinct patterns once, then a fixed width index per value.
+ */
+const int PREDICTOR_BITS = 3;
+const int MAX_ORDER = 2;
+const uint64_t CONSTANT = 3;
+const uint64_t RAW = 4;
+const uint64_t DICTIONARY = 5;
+
+/**
+ * Finite difference derivatives of a float position are quantized to a
+ * few multiples of ulp / dt, a chunk rarely holds more distinct values.
+ */
+const int MAX_INDEX_BITS = 8;
+const int INDEX_BITS_BITS = 4;
+const int DICTIONARY_SIZE_BITS = MAX_INDEX_BITS + 1;
+
+/**
+ * Writes most significant bit first, word by word.
+ */
+class BitWriter{
+public:
+    BitWriter(std::vector<uint64_t>& words) :
+            words_(words), bits_(0){}
+
+    /**
+     * Appends a zero word so readers may always look one word ahead,
+     * returns the bits written.
+     */
+    std::size_t Finish(){
+        words_.push_back(0);
+        return bits_;
+    }
+
+    void Write(uint64_t value, int count){
+        if(count == 0)
+            return;
+        int used = (int)(bits_ & 63);
+        if(used == 0)
+            words_.push_back(0);
+        int free = 64 - used;
+        if(count <= free){
+            words_.back() |= value << (free - count);
+        }else{
+            int rest = count - free;
+            words_.back() |= value >> rest;
+            words_.push_back(value << (64 - rest));
+        }
+        bits_ += count;
+    }
+
+private:
+    std::vector<uint64_t>& words_;
+    std::size_t bits_;
+};
+
+/**
+ * Reads through a 64 bit window, words must end with the padding word
+ * EncodeFloats appends.
+ */
+class BitReader{
+public:
+    BitReader(const uint64_t* words) :
+            words_(words), bits_(0){}
+
+    uint64_t Read(int count){
+        if(count == 0)
+            return 0;
+        uint64_t value = Peek() >> (64 - count);
+        bits_ += count;
+        return value;
+    }
+
+    /**
+     * Number of leading 1 bits, at most limit, consuming them and the
+     * terminating 0 if there is one.
+     */
+    int ReadOnes(int limit){
+        uint64_t inverted = ~Peek();
+        int ones = inverted == 0 ? 64 : __builtin_clzll(inverted);
+        if(ones >= limit){
+            bits_ += limit;
+            return limit;
+        }
+        bits_ += ones + 1;
+        return ones;
+    }
+
+private:
+    uint64_t Peek() const {
+        std::size_t word = bits_ >> 6;
+        int used = (int)(bits_ & 63);
+        if(used == 0)
+            return words_[word];
+        return (words_[word] << used) | (words_[word + 1] >> (64 - used));
+    }
+
+    const uint64_t* words_;
+    std::size_t bits_;
+};
+
+uint32_t FloatBits(float value){
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+float BitsFloat(uint32_t bits){
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * Extrapolation of the previous patterns up to order, lower orders while
+ * fewer are known.
+ */
+int64_t Predict(const int64_t* history, std::size_t index, int order){
+    if(index == 0)
+        return 0;
+    if(index == 1 || order == 0)
+        return history[0];
+    if(index == 2 || order == 1)
+        return 2 * history[0] - history[1];
+    return 3 * history[0] - 3 * history[1] + history[2];
+}
+
+uint64_t ZigZag(int64_t residual){
+    return residual < 0 ? ((uint64_t)(-residual) << 1) - 1
+                        : (uint64_t)residual << 1;
+}
+
+int Bucket(uint64_t zigzag){
+    int bucket = 0;
+    while(bucket < RAW_BUCKET
+          && zigzag - BUCKETS[bucket].base
+             >= (uint64_t)1 << BUCKETS[bucket].payload_bits)
+        bucket++;
+    return bucket;
+}
+
+void Shift(int64_t* history, int64_t value){
+    history[2] = history[1];
+    history[1] = history[0];
+    history[0] = value;
+}
+
+/**
+ * Size of the residuals of one predictor order, without writing them.
+ */
+std::size_t ResidualBits(const float* values, std::size_t count, int order){
+    std::size_t bits = 0;
+    int64_t history[3] = {0, 0, 0};
+    for(std::size_t i = 0; i < count; i++){
+        int64_t pattern = FloatBits(values[i]);
+        const ResidualBucket& code = BUCKETS[Bucket(ZigZag(
+                pattern - Predict(history, i, order)))];
+        bits += code.prefix_bits + code.payload_bits;
+        Shift(history, pattern);
+    }
+    return bits;
+}
+
+/**
+ * Sorted distinct patterns of values, empty if there are more than
+ * 2^MAX_INDEX_BITS.
+ */
+std::vector<uint32_t> Dictionary(const float* values, std::size_t count){
+    std::vector<uint32_t> dictionary(count);
+    for(std::size_t i = 0; i < count; i++)
+        dictionary[i] = FloatBits(values[i]);
+    std::sort(dictionary.begin(), dictionary.end());
+    dictionary.erase(std::unique(dictionary.begin(), dictionary.end()),
+                     dictionary.end());
+    if(dictionary.size() > ((std::size_t)1 << MAX_INDEX_BITS))
+        dictionary.clear();
+    return dictionary;
+}
+
+int IndexBits(std::size_t dictionary_size){
+    int bits = 0;
+    while(((std::size_t)1 << bits) < dictionary_size)
+        bits++;
+    return bits;
+}
+
+bool IsConstant(const float* values, std::size_t count){
+    for(std::size_t i = 1; i < count; i++){
+        if(FloatBits(values[i]) != FloatBits(values[0]))
+            return false;
+    }
+    return true;
+}
+
+}
+
+std::size_t EncodeFloats(const float* values, std::size_t count,
+                         std::vector<uint64_t>& words){
+    words.clear();
+    BitWriter writer(words);
+    if(count > 0 && IsConstant(values, count)){
+        writer.Write(CONSTANT, PREDICTOR_BITS);
+        writer.Write(FloatBits(values[0]), 32);
+        return writer.Finish();
+    }
+
+    int order = 0;
+    std::size_t best_bits = ResidualBits(values, count, 0);
+    for(int candidate = 1; candidate <= MAX_ORDER; candidate++){
+        std::size_t bits = ResidualBits(values, count, candidate);
+        if(bits < best_bits){
+            best_bits = bits;
+            order = candidate;
+        }
+    }
+    if(best_bits >= 32 * count){
+        writer.Write(RAW, PREDICTOR_BITS);
+        for(std::size_t i = 0; i < count; i++)
+            writer.Write(FloatBits(values[i]), 32);
+        return writer.Finish();
+    }
+
+    std::vector<uint32_t> dictionary = Dictionary(values, count);
+    int index_bits = IndexBits(dictionary.size());
+    if(!dictionary.empty()
+       && INDEX_BITS_BITS + DICTIONARY_SIZE_BITS + 32 * dictionary.size()
+          + index_bits * count < best_bits){
+        writer.Write(DICTIONARY, PREDICTOR_BITS);
+        writer.Write((uint64_t)index_bits, INDEX_BITS_BITS);
+        writer.Write(dictionary.size() - 1, DICTIONARY_SIZE_BITS);
+        for(std::size_t i = 0; i < dictionary.size(); i++)
+            writer.Write(dictionary[i], 32);
+        for(std::size_t i = 0; i < count; i++){
+            std::size_t index = std::lower_bound(
+                    dictionary.begin(), dictionary.end(),
+                    FloatBits(values[i])) - dictionary.begin();
+            writer.Write(index, index_bits);
+        }
+        return writer.Finish();
+    }
+    writer.Write((uint64_t)order, PREDICTOR_BITS);
+
+    int64_t history[3] = {0, 0, 0};
+    for(std::size_t i = 0; i < count; i++){
+        int64_t pattern = FloatBits(values[i]);
+        uint64_t zigzag = ZigZag(pattern - Predict(history, i, order));
+        Shift(history, pattern);
+
+        int bucket = Bucket(zigzag);
+        const ResidualBucket& code = BUCKETS[bucket];
+        writer.Write(code.prefix, code.prefix_bits);
+        if(bucket == RAW_BUCKET)
+            writer.Write((uint64_t)pattern, code.payload_bits);
+        else
+            writer.Write(zigzag - code.base, code.payload_bits);
+    }
+    return writer.Finish();
+}
+
+void DecodeFloats(const uint64_t* words, std::size_t count, float* values){
+    BitReader reader(words);
+    uint64_t predictor = reader.Read(PREDICTOR_BITS);
+    if(predictor == CONSTANT){
+        float value = BitsFloat((uint32_t)reader.Read(32));
+        for(std::size_t i = 0; i < count; i++)
+            values[i] = value;
+        return;
+    }
+    if(predictor == RAW){
+        for(std::size_t i = 0; i < count; i++)
+            values[i] = BitsFloat((uint32_t)reader.Read(32));
+        return;
+    }
+    if(predictor == DICTIONARY){
+        int index_bits = (int)reader.Read(INDEX_BITS_BITS);
+        std::size_t size = reader.Read(DICTIONARY_SIZE_BITS) + 1;
+        float dictionary[(std::size_t)1 << MAX_INDEX_BITS];
+        for(std::size_t i = 0; i < size; i++)
+            dictionary[i] = BitsFloat((uint32_t)reader.Read(32));
+        for(std::size_t i = 0; i < count; i++)
+            values[i] = dictionary[reader.Read(index_bits)];
+        return;
+    }
+
+    int order = (int)predictor;
+    int64_t history[3] = {0, 0, 0};
+    for(std::size_t i = 0; i < count; i++){
+        int bucket = reader.ReadOnes(RAW_BUCKET);
+        const ResidualBucket& code = BUCKETS[bucket];
+        uint64_t payload = reader.Read(code.payload_bits);
+
+        int64_t pattern;
+        if(bucket == RAW_BUCKET){
+            pattern = (int64_t)payload;
+        }else{
+            uint64_t zigzag = payload + code.base;
+            int64_t residual = (zigzag & 1) ? -(int64_t)((zigzag + 1) >> 1)
+                                            : (int64_t)(zigzag >> 1);
+            pattern = Predict(history, i, order) + residual;
+        }
+        Shift(history, pattern);
+        values[i] = BitsFloat((uint32_t)pattern);
+    }
+}
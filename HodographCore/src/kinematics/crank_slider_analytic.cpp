@@ -0,0 +1,17 @@
+#include "kinematics/crank_slider_analytic.h"
+
+#include <kinematics/crank_slider_kernel.h>
+
+void EvaluateCrankSlider(const float* sin_alpha, const float* cos_alpha,
+                         std::size_t count,
+                         float radius, float line_length,
+                         float angular_velocity,
+                         float* positions, float* velocities,
+                         float* accelerations){
+    for(std::size_t i = 0; i < count; i++){
+        EvaluateCrankSliderPoint(sin_alpha[i], cos_alpha[i],
+                                 radius, line_length, angular_velocity,
+                                 positions[i], velocities[i],
+                                 accelerations[i]);
+    }
+}
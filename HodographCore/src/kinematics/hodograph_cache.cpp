@@ -0,0 +1,176 @@
+#include "kinematics/hodograph_cache.h"
+
+#include <algorithm>
+
+const std::size_t HodographCache::DEFAULT_CAPACITY;
+
+namespace {
+
+float Component(const Vec3& value, int axis){
+    return axis == 0 ? value.x : (axis == 1 ? value.y : value.z);
+}
+
+}
+
+HodographCache::HodographCache(std::size_t capacity,
+                               unsigned int recorded_axes) :
+        capacity_(capacity == 0 ? 1 : capacity),
+        head_(0),
+        size_(0){
+    for(int c = 0; c < HODOGRAPH_CHANNEL_COUNT; c++){
+        recorded_axes_[c] = 0;
+        for(int a = 0; a < AXIS_COUNT; a++){
+            constants_[c][a] = 0;
+            columns_[c][a].assign(capacity_, 0);
+            pyramids_[c][a].SetCapacity(capacity_);
+            if(recorded_axes & (1u << a))
+                EnableAxis(c, a);
+        }
+    }
+}
+
+HodographCache::~HodographCache(){}
+
+void HodographCache::Push(const HodographSample& sample){
+    Push(static_cast<int>(HodographChannel::POSITION), sample.position);
+    Push(static_cast<int>(HodographChannel::VELOCITY), sample.velocity);
+    Push(static_cast<int>(HodographChannel::ACCELERATION),
+         sample.acceleration);
+
+    if(++head_ == capacity_)
+        head_ = 0;
+    if(size_ < capacity_)
+        size_++;
+}
+
+void HodographCache::Push(int channel, const Vec3& value){
+    for(int a = 0; a < AXIS_COUNT; a++){
+        float component = Component(value, a);
+        if(!(recorded_axes_[channel] & (1u << a))){
+            if(size_ == 0)
+                constants_[channel][a] = component;
+            if(component == constants_[channel][a])
+                continue;
+            EnableAxis(channel, a);
+        }
+        columns_[channel][a][head_] = component;
+        pyramids_[channel][a].Push(component);
+    }
+}
+
+void HodographCache::EnableAxis(int channel, int axis){
+    // Storage is allocated up front, Push never allocates.
+    float constant = constants_[channel][axis];
+    std::fill(columns_[channel][axis].begin(), columns_[channel][axis].end(),
+              constant);
+    pyramids_[channel][axis].Clear();
+    for(std::size_t i = 0; i < size_; i++)
+        pyramids_[channel][axis].Push(constant);
+    recorded_axes_[channel] |= 1u << axis;
+}
+
+void HodographCache::Clear(){
+    head_ = 0;
+    size_ = 0;
+    for(int c = 0; c < HODOGRAPH_CHANNEL_COUNT; c++){
+        for(int a = 0; a < AXIS_COUNT; a++)
+            pyramids_[c][a].Clear();
+    }
+}
+
+void HodographCache::SetCapacity(std::size_t capacity){
+    capacity_ = capacity == 0 ? 1 : capacity;
+    for(int c = 0; c < HODOGRAPH_CHANNEL_COUNT; c++){
+        for(int a = 0; a < AXIS_COUNT; a++){
+            columns_[c][a].assign(capacity_, constants_[c][a]);
+            columns_[c][a].shrink_to_fit();
+            pyramids_[c][a].SetCapacity(capacity_);
+        }
+    }
+    Clear();
+}
+
+bool HodographCache::IsRecorded(HodographChannel channel, Axis axis) const {
+    return (recorded_axes_[static_cast<int>(channel)]
+            & (1u << static_cast<int>(axis))) != 0;
+}
+
+float HodographCache::Constant(HodographChannel channel, Axis axis) const {
+    return constants_[static_cast<int>(channel)][static_cast<int>(axis)];
+}
+
+RingView<float> HodographCache::View(HodographChannel channel,
+                                     Axis axis) const {
+    RingView<float> view;
+    if(!IsRecorded(channel, axis)){
+        view.data = nullptr;
+        view.size = 0;
+        view.offset = 0;
+        return view;
+    }
+    view.data = columns_[static_cast<int>(channel)]
+                        [static_cast<int>(axis)].data();
+    view.size = (int)size_;
+    view.offset = (int)offset();
+    return view;
+}
+
+float HodographCache::Get(HodographChannel channel, Axis axis,
+                          std::size_t i) const {
+    if(!IsRecorded(channel, axis))
+        return Constant(channel, axis);
+
+    std::size_t index = offset() + i;
+    if(index >= capacity_)
+        index -= capacity_;
+    return columns_[static_cast<int>(channel)]
+                   [static_cast<int>(axis)][index];
+}
+
+Vec3 HodographCache::Get(HodographChannel channel, std::size_t i) const {
+    return Vec3(Get(channel, Axis::X, i),
+                Get(channel, Axis::Y, i),
+                Get(channel, Axis::Z, i));
+}
+
+HodographSample HodographCache::GetSample(std::size_t i) const {
+    HodographSample sample;
+    sample.position = Get(HodographChannel::POSITION, i);
+    sample.velocity = Get(HodographChannel::VELOCITY, i);
+    sample.acceleration = Get(HodographChannel::ACCELERATION, i);
+    return sample;
+}
+
+MinMax HodographCache::Range(HodographChannel channel, Axis axis,
+                             std::size_t begin, std::size_t end) const {
+    if(!IsRecorded(channel, axis)){
+        float constant = Constant(channel, axis);
+        return MinMax{constant, constant};
+    }
+    return pyramids_[static_cast<int>(channel)][static_cast<int>(axis)]
+            .Range(View(channel, axis), begin, end);
+}
+
+MinMax HodographCache::Resample(HodographChannel channel, Axis axis,
+                                std::size_t begin, std::size_t end,
+                                MinMax* columns, int width) const {
+    if(!IsRecorded(channel, axis)){
+        float constant = Constant(channel, axis);
+        for(int i = 0; i < width; i++)
+            columns[i] = MinMax{constant, constant};
+        return MinMax{constant, constant};
+    }
+    return pyramids_[static_cast<int>(channel)][static_cast<int>(axis)]
+            .Resample(View(channel, axis), begin, end, columns, width);
+}
+
+std::size_t HodographCache::memory_bytes() const {
+    std::size_t bytes = 0;
+    for(int c = 0; c < HODOGRAPH_CHANNEL_COUNT; c++){
+        for(int a = 0; a < AXIS_COUNT; a++){
+            bytes += columns_[c][a].capacity() * sizeof(float);
+            bytes += pyramids_[c][a].memory_bytes();
+        }
+    }
+    return bytes;
+}
@@ -0,0 +1,216 @@
+#include "kinematics/hodograph_ensemble.h"
+
+#include <cmath>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+struct EnsembleKernel{
+    float line_length;
+    float error;
+    float z0;
+    float y0;
+    float inv_2dt;
+    float inv_dt_sqr;
+};
+
+/**
+ * Advances members [begin, end):
+ *  z_new = z0 + sqrt((L - y0)(L + y0)), L = line_length + error * noise,
+ *  the same SliderOffset as HodographKinematics
+ *  v = (z_new - z_last) / 2dt
+ *  a = (z_new - 2z + z_last) / dt^2
+ */
+void UpdateMembersScalar(const EnsembleKernel& k,
+                         const float* noise, float* z, float* z_last,
+                         float* velocities, float* accelerations,
+                         std::size_t begin, std::size_t end){
+    for(std::size_t i = begin; i < end; i++){
+        float l = k.line_length + k.error * noise[i];
+        float z_new = k.z0 + sqrtf((l - k.y0) * (l + k.y0));
+
+        velocities[i] = (z_new - z_last[i]) * k.inv_2dt;
+        accelerations[i] = (z_new - 2.0f * z[i] + z_last[i]) * k.inv_dt_sqr;
+
+        z_last[i] = z[i];
+        z[i] = z_new;
+    }
+}
+
+#if defined(__AVX2__)
+
+std::size_t UpdateMembersSIMD(const EnsembleKernel& k,
+                              const float* noise, float* z, float* z_last,
+                              float* velocities, float* accelerations,
+                              std::size_t count){
+    const __m256 line_length = _mm256_set1_ps(k.line_length);
+    const __m256 error = _mm256_set1_ps(k.error);
+    const __m256 z0 = _mm256_set1_ps(k.z0);
+    const __m256 y0 = _mm256_set1_ps(k.y0);
+    const __m256 inv_2dt = _mm256_set1_ps(k.inv_2dt);
+    const __m256 inv_dt_sqr = _mm256_set1_ps(k.inv_dt_sqr);
+    const __m256 two = _mm256_set1_ps(2.0f);
+
+    std::size_t i = 0;
+    for(; i + 8 <= count; i += 8){
+        __m256 l = _mm256_add_ps(line_length,
+                                 _mm256_mul_ps(error,
+                                               _mm256_loadu_ps(noise + i)));
+        __m256 z_new = _mm256_add_ps(
+                z0, _mm256_sqrt_ps(_mm256_mul_ps(_mm256_sub_ps(l, y0),
+                                                 _mm256_add_ps(l, y0))));
+        __m256 current = _mm256_loadu_ps(z + i);
+        __m256 last = _mm256_loadu_ps(z_last + i);
+
+        __m256 velocity = _mm256_mul_ps(_mm256_sub_ps(z_new, last), inv_2dt);
+        __m256 acceleration = _mm256_mul_ps(
+                _mm256_add_ps(_mm256_sub_ps(z_new,
+                                            _mm256_mul_ps(two, current)),
+                              last),
+                inv_dt_sqr);
+
+        _mm256_storeu_ps(velocities + i, velocity);
+        _mm256_storeu_ps(accelerations + i, acceleration);
+        _mm256_storeu_ps(z_last + i, current);
+        _mm256_storeu_ps(z + i, z_new);
+    }
+    return i;
+}
+
+#elif defined(__SSE2__)
+
+std::size_t UpdateMembersSIMD(const EnsembleKernel& k,
+                              const float* noise, float* z, float* z_last,
+                              float* velocities, float* accelerations,
+                              std::size_t count){
+    const __m128 line_length = _mm_set1_ps(k.line_length);
+    const __m128 error = _mm_set1_ps(k.error);
+    const __m128 z0 = _mm_set1_ps(k.z0);
+    const __m128 y0 = _mm_set1_ps(k.y0);
+    const __m128 inv_2dt = _mm_set1_ps(k.inv_2dt);
+    const __m128 inv_dt_sqr = _mm_set1_ps(k.inv_dt_sqr);
+    const __m128 two = _mm_set1_ps(2.0f);
+
+    std::size_t i = 0;
+    for(; i + 4 <= count; i += 4){
+        __m128 l = _mm_add_ps(line_length,
+                              _mm_mul_ps(error, _mm_loadu_ps(noise + i)));
+        __m128 z_new = _mm_add_ps(
+                z0, _mm_sqrt_ps(_mm_mul_ps(_mm_sub_ps(l, y0),
+                                           _mm_add_ps(l, y0))));
+        __m128 current = _mm_loadu_ps(z + i);
+        __m128 last = _mm_loadu_ps(z_last + i);
+
+        __m128 velocity = _mm_mul_ps(_mm_sub_ps(z_new, last), inv_2dt);
+        __m128 acceleration = _mm_mul_ps(
+                _mm_add_ps(_mm_sub_ps(z_new, _mm_mul_ps(two, current)), last),
+                inv_dt_sqr);
+
+        _mm_storeu_ps(velocities + i, velocity);
+        _mm_storeu_ps(accelerations + i, acceleration);
+        _mm_storeu_ps(z_last + i, current);
+        _mm_storeu_ps(z + i, z_new);
+    }
+    return i;
+}
+
+#else
+
+std::size_t UpdateMembersSIMD(const EnsembleKernel&,
+                              const float*, float*, float*, float*, float*,
+                              std::size_t){
+    return 0;
+}
+
+#endif
+
+}
+
+HodographEnsemble::HodographEnsemble(std::size_t size) :
+        alpha_(0){
+    Reset(size);
+}
+
+HodographEnsemble::~HodographEnsemble(){}
+
+void HodographEnsemble::Update(float time_delta){
+    UpdateNoise();
+    UpdateMembers(time_delta);
+    UpdateAlpha(time_delta);
+
+    is_first_iteration_ = false;
+}
+
+void HodographEnsemble::UpdateStatistics(){
+    std::size_t count = size();
+    statistics_.position = ComputeSummaryStatistics(z_.data(), count,
+                                                    scratch_);
+    statistics_.velocity = ComputeSummaryStatistics(velocities_.data(), count,
+                                                    scratch_);
+    statistics_.acceleration = ComputeSummaryStatistics(accelerations_.data(),
+                                                        count, scratch_);
+}
+
+void HodographEnsemble::Reset(std::size_t size){
+    noise_.assign(size, 0);
+    z_.assign(size, 0);
+    z_last_.assign(size, 0);
+    velocities_.assign(size, 0);
+    accelerations_.assign(size, 0);
+    scratch_.assign(size, 0);
+
+    Reset();
+}
+
+void HodographEnsemble::Reset(){
+    alpha_ = 0;
+    noise_stream_.Seek(0);
+    statistics_ = EnsembleStep();
+    is_first_iteration_ = true;
+}
+
+void HodographEnsemble::UpdateNoise(){
+    noise_stream_.Fill(noise_.data(), noise_.size());
+}
+
+void HodographEnsemble::UpdateMembers(float time_delta){
+    EnsembleKernel kernel;
+    kernel.line_length = parameters_.line_length;
+    kernel.error = parameters_.error;
+    kernel.z0 = parameters_.radius * sin(alpha_);
+    kernel.y0 = parameters_.radius * cos(alpha_);
+    kernel.inv_2dt = 1.0f / (2.0f * time_delta);
+    kernel.inv_dt_sqr = 1.0f / (time_delta * time_delta);
+
+    std::size_t count = size();
+    if(is_first_iteration_){
+        // Same as HodographKinematics: history starts at the first position.
+        UpdateMembersScalar(kernel, noise_.data(), z_.data(), z_last_.data(),
+                            velocities_.data(), accelerations_.data(),
+                            0, count);
+        z_last_ = z_;
+        velocities_.assign(count, 0);
+        accelerations_.assign(count, 0);
+        return;
+    }
+
+    std::size_t done = UpdateMembersSIMD(kernel, noise_.data(), z_.data(),
+                                         z_last_.data(), velocities_.data(),
+                                         accelerations_.data(), count);
+    UpdateMembersScalar(kernel, noise_.data(), z_.data(), z_last_.data(),
+                        velocities_.data(), accelerations_.data(),
+                        done, count);
+}
+
+void HodographEnsemble::UpdateAlpha(float time_delta){
+    const double two_pi = 2 * M_PI;
+    alpha_ += parameters_.angular_velocity * time_delta;
+    if(alpha_ >= two_pi || alpha_ < 0){
+        alpha_ = std::fmod(alpha_, two_pi);
+        if(alpha_ < 0)
+            alpha_ += two_pi;
+    }
+}
@@ -0,0 +1,355 @@
+#include "kinematics/hodograph_kinematics.h"
+
+#include <kinematics/angle_rotation.h>
+#include <kinematics/crank_slider_kernel.h>
+#include <profiling/profiler.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/**
+ * Longest filter delay diagnostics and cycles can look back to, see
+ * FilterSettings.
+ */
+const std::size_t DELAY_HISTORY_CAPACITY = 128;
+
+}
+
+HodographKinematics::HodographKinematics(std::size_t cache_capacity) :
+        alpha_(0),
+        wrapped_(false),
+        sample_alpha_(0),
+        sin_alpha_(0),
+        cos_alpha_(1),
+        line_error_length_(parameters_.line_length),
+        line_history_size_(0),
+        sample_valid_(false),
+        derivative_method_(DerivativeMethod::FINITE_DIFFERENCE),
+        diagnostics_enabled_(false),
+        analytic_history_(DELAY_HISTORY_CAPACITY),
+        sensitivity_enabled_(false),
+        alpha_angular_velocity_derivative_(0),
+        hodograph_cache_(cache_capacity),
+        cache_enabled_(true),
+        statistics_enabled_(true),
+        cycle_phases_(DELAY_HISTORY_CAPACITY),
+        cycles_enabled_(false),
+        cycle_completed_(false),
+        error_deviation_(0),
+        time_(0),
+        is_first_iteration_(true){}
+
+HodographKinematics::~HodographKinematics(){}
+
+void HodographKinematics::parameters(const HodographParameters& value){
+    if(value.angular_velocity != parameters_.angular_velocity)
+        alpha_angular_velocity_derivative_ = 0;
+    parameters_ = value;
+}
+
+void HodographKinematics::Update(float time_delta){
+    sin_alpha_ = sin(alpha_);
+    cos_alpha_ = cos(alpha_);
+    Advance(time_delta);
+}
+
+void HodographKinematics::Step(std::size_t count, float time_delta,
+                               HodographSample* samples){
+    ProfileScope scope("Step", Profiler::detailed());
+    AngleRotation rotation(alpha_, parameters_.angular_velocity * time_delta);
+    for(std::size_t i = 0; i < count; i++){
+        sin_alpha_ = (float)rotation.sin();
+        cos_alpha_ = (float)rotation.cos();
+
+        Advance(time_delta);
+        if(samples)
+            samples[i] = sample_;
+
+        if(wrapped_)
+            rotation.Reset(alpha_);
+        else
+            rotation.Next();
+    }
+}
+
+void HodographKinematics::Advance(float time_delta){
+    UpdateLine(time_delta);
+    UpdateSample(time_delta);
+    time_ += time_delta;
+    if(cycles_enabled_)
+        UpdateCycles(time_delta);
+    UpdateCache();
+
+    is_first_iteration_ = false;
+}
+
+void HodographKinematics::ResetCache(){
+    hodograph_cache_.Clear();
+    statistics_.Clear();
+    cycles_.Clear();
+    alpha_angular_velocity_derivative_ = 0;
+}
+
+void HodographKinematics::UpdateLine(float time_delta){
+    ProfileScope scope("UpdateLine", Profiler::detailed());
+    UpdateErrorLine();
+    UpdateLinePosition(time_delta);
+}
+
+void HodographKinematics::UpdateErrorLine(){
+    float error_t = parameters_.error * noise_stream_.Next();
+
+    line_error_length_ = parameters_.line_length + error_t;
+}
+
+void HodographKinematics::UpdateLinePosition(float time_delta){
+    UpdateLinePosition0();
+    UpdateLinePosition1();
+    if(sensitivity_enabled_)
+        UpdateLineSensitivity();
+
+    sample_alpha_ = alpha_;
+    UpdateAlpha(time_delta);
+}
+
+void HodographKinematics::UpdateLinePosition0(){
+    const float x = -0.01;
+    float z0 = parameters_.radius * sin_alpha_;
+    float y0 = parameters_.radius * cos_alpha_;
+    line_.position0 = Vec3(x,y0,z0);
+}
+
+void HodographKinematics::UpdateLinePosition1(){
+    const float x = -0.01;
+
+    float lx1 = SliderOffset(line_error_length_, line_.position0.y);
+    float z1 = line_.position0.z + lx1;
+    if(cycles_enabled_){
+        error_deviation_ = lx1 - SliderOffset(parameters_.line_length,
+                                              line_.position0.y);
+    }
+
+    if(is_first_iteration_){
+        line_.position1 = Vec3(x, 0, z1);
+        line_.last_last_position1 = line_.position1;
+        line_.last_position1 = line_.position1;
+    }else{
+        line_.last_last_position1 = line_.last_position1;
+        line_.last_position1 = line_.position1;
+        line_.position1 = Vec3(x, 0, z1);
+    }
+    if(line_history_size_ < 3)
+        line_history_size_++;
+}
+
+void HodographKinematics::UpdateLineSensitivity(){
+    const int radius = static_cast<int>(SensitivityParameter::RADIUS);
+    const int line_length
+            = static_cast<int>(SensitivityParameter::LINE_LENGTH);
+    const int angular_velocity
+            = static_cast<int>(SensitivityParameter::ANGULAR_VELOCITY);
+
+    // The derivatives reuse sin and cos of the float path.
+    double dalpha = alpha_angular_velocity_derivative_;
+    dual_sin_alpha_ = SensitivityDual(sin_alpha_);
+    dual_sin_alpha_.d[angular_velocity] = cos_alpha_ * dalpha;
+    dual_cos_alpha_ = SensitivityDual(cos_alpha_);
+    dual_cos_alpha_.d[angular_velocity] = -sin_alpha_ * dalpha;
+
+    SensitivityDual position1 = SliderPosition(
+            dual_sin_alpha_, dual_cos_alpha_,
+            SensitivityDual::Variable(parameters_.radius, radius),
+            SensitivityDual::Variable(line_error_length_, line_length));
+
+    if(is_first_iteration_){
+        dual_last_last_position1_ = position1;
+        dual_last_position1_ = position1;
+    }else{
+        dual_last_last_position1_ = dual_last_position1_;
+        dual_last_position1_ = dual_position1_;
+    }
+    dual_position1_ = position1;
+}
+
+void HodographKinematics::UpdateAlpha(float time_delta){
+    alpha_ += parameters_.angular_velocity * time_delta;
+    alpha_angular_velocity_derivative_ += time_delta;
+    ClampAlpha();
+}
+
+void HodographKinematics::ClampAlpha(){
+    // Keep the overshoot, dropping it would lose up to one step of phase
+    // every revolution.
+    const double two_pi = 2 * M_PI;
+    wrapped_ = alpha_ >= two_pi || alpha_ < 0;
+    if(wrapped_){
+        alpha_ = std::fmod(alpha_, two_pi);
+        if(alpha_ < 0)
+            alpha_ += two_pi;
+    }
+}
+
+void HodographKinematics::UpdateSample(float time_delta){
+    ProfileScope scope("UpdateSample", Profiler::detailed());
+    auto& current = line_.position1;
+    auto& last = line_.last_position1;
+    auto& last_last = line_.last_last_position1;
+
+    float time_delta_sqr = time_delta * time_delta;
+    Vec3 velocity = (current - last_last) / (2.0f * time_delta);
+    Vec3 acceleration = (current - (last*2.0f) + last_last)
+                        / (time_delta_sqr);
+
+    bool analytic = derivative_method_ == DerivativeMethod::ANALYTIC;
+    if(analytic || diagnostics_enabled_)
+        UpdateAnalyticSample();
+    if(sensitivity_enabled_)
+        UpdateSampleSensitivity(time_delta);
+
+    bool filtered = !analytic && filter_settings_.type != FilterType::NONE;
+    if(filtered){
+        filter_.Configure(filter_settings_, time_delta);
+        sample_ = filter_.Push(current);
+        sample_valid_ = filter_.settled();
+    }else{
+        sample_valid_ = analytic || line_history_size_ == 3;
+        sample_.position = current;
+        sample_.velocity = analytic ? analytic_sample_.velocity : velocity;
+        sample_.acceleration = analytic ? analytic_sample_.acceleration
+                                        : acceleration;
+    }
+
+    if(diagnostics_enabled_){
+        analytic_history_.Push(analytic_sample_);
+
+        // Central differences describe the previous step, filters their
+        // group delay.
+        std::size_t delay = filtered ? (std::size_t)std::lround(
+                FilterGroupDelay(filter_settings_)) : 1;
+        std::size_t size = analytic_history_.size();
+        const HodographSample& reference
+                = analytic_history_[size > delay ? size - 1 - delay : 0];
+
+        HodographSample estimate = sample_;
+        if(!filtered){
+            estimate.position = reference.position;
+            estimate.velocity = velocity;
+            estimate.acceleration = acceleration;
+        }
+        derivative_difference_.position = estimate.position
+                                          - reference.position;
+        derivative_difference_.velocity = estimate.velocity
+                                          - reference.velocity;
+        derivative_difference_.acceleration = estimate.acceleration
+                                              - reference.acceleration;
+    }
+}
+
+void HodographKinematics::UpdateAnalyticSample(){
+    float position;
+    float velocity;
+    float acceleration;
+    EvaluateCrankSlider(&sin_alpha_, &cos_alpha_, 1,
+                        parameters_.radius, parameters_.line_length,
+                        parameters_.angular_velocity,
+                        &position, &velocity, &acceleration);
+
+    analytic_sample_.position = Vec3(line_.position1.x, 0, position);
+    analytic_sample_.velocity = Vec3(0, 0, velocity);
+    analytic_sample_.acceleration = Vec3(0, 0, acceleration);
+}
+
+void HodographKinematics::UpdateSampleSensitivity(float time_delta){
+    SensitivityDual position;
+    SensitivityDual velocity;
+    SensitivityDual acceleration;
+    if(derivative_method_ == DerivativeMethod::ANALYTIC){
+        // Like UpdateAnalyticSample, without the rod length error.
+        EvaluateCrankSliderPoint(
+                dual_sin_alpha_, dual_cos_alpha_,
+                SensitivityDual::Variable(
+                        parameters_.radius,
+                        static_cast<int>(SensitivityParameter::RADIUS)),
+                SensitivityDual::Variable(
+                        parameters_.line_length,
+                        static_cast<int>(SensitivityParameter::LINE_LENGTH)),
+                SensitivityDual::Variable(
+                        parameters_.angular_velocity,
+                        static_cast<int>(
+                                SensitivityParameter::ANGULAR_VELOCITY)),
+                position, velocity, acceleration);
+    }else{
+        const SensitivityDual& current = dual_position1_;
+        const SensitivityDual& last = dual_last_position1_;
+        const SensitivityDual& last_last = dual_last_last_position1_;
+        position = current;
+        velocity = (current - last_last) / (2.0f * time_delta);
+        acceleration = (current - 2.0f * last + last_last)
+                       / (time_delta * time_delta);
+    }
+
+    for(int i = 0; i < SENSITIVITY_PARAMETER_COUNT; i++){
+        SliderSensitivity& parameter = sensitivity_.parameters[i];
+        parameter.position = position.d[i];
+        parameter.velocity = velocity.d[i];
+        parameter.acceleration = acceleration.d[i];
+    }
+}
+
+void HodographKinematics::UpdateCycles(float time_delta){
+    ProfileScope scope("UpdateCycles", Profiler::detailed());
+    CyclePhase phase;
+    phase.time = time_;
+    phase.alpha = (float)sample_alpha_;
+    phase.deviation = error_deviation_;
+    phase.wrapped = wrapped_;
+    phase.wrap_time = 0;
+    if(wrapped_){
+        // The angle crossed the wrap between this step and the next one,
+        // alpha_ - wrap / w before the next step.
+        const double two_pi = 2 * M_PI;
+        double angular_velocity = parameters_.angular_velocity;
+        double overshoot = angular_velocity > 0 ? alpha_ : alpha_ - two_pi;
+        phase.wrap_time = time_ + time_delta - overshoot / angular_velocity;
+    }
+    cycle_phases_.Push(phase);
+
+    cycle_completed_ = false;
+    std::size_t delay = SampleDelay();
+    std::size_t size = cycle_phases_.size();
+    if(size <= delay)
+        return;
+    const CyclePhase& described = cycle_phases_[size - 1 - delay];
+    if(sample_valid_){
+        // Central differences pair the current position with the
+        // derivatives of the previous step.
+        HodographSample sample = sample_;
+        bool analytic = derivative_method_ == DerivativeMethod::ANALYTIC;
+        if(!analytic && filter_settings_.type == FilterType::NONE)
+            sample.position = line_.last_position1;
+        cycles_.Push(described.time, described.alpha, sample,
+                     described.deviation);
+    }
+    if(described.wrapped)
+        cycle_completed_ = cycles_.Finish(described.wrap_time);
+}
+
+std::size_t HodographKinematics::SampleDelay(){
+    if(derivative_method_ == DerivativeMethod::ANALYTIC)
+        return 0;
+    if(filter_settings_.type == FilterType::NONE)
+        return 1;
+    std::size_t delay = (std::size_t)std::lround(
+            FilterGroupDelay(filter_settings_));
+    return std::min(delay, DELAY_HISTORY_CAPACITY - 1);
+}
+
+void HodographKinematics::UpdateCache(){
+    ProfileScope scope("UpdateCache", Profiler::detailed());
+    if(cache_enabled_)
+        hodograph_cache_.Push(sample_);
+    if(statistics_enabled_ && sample_valid_)
+        statistics_.Push(sample_, time_);
+}
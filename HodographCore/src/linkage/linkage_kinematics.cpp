@@ -0,0 +1,86 @@
+#include "linkage/linkage_kinematics.h"
+
+#include <profiling/profiler.h>
+
+#include <cmath>
+
+namespace {
+
+/**
+ * Depth of the mechanism plane, see HodographKinematics.
+ */
+const float PLANE_X = -0.01;
+
+}
+
+LinkageKinematics::LinkageKinematics(std::size_t cache_capacity) :
+        alpha_(0),
+        line_error_length_(parameters_.line_length),
+        status_(LinkageStatus::OK),
+        singular_steps_(0),
+        hodograph_cache_(cache_capacity),
+        cache_enabled_(true),
+        time_(0){
+    Rebuild();
+}
+
+LinkageKinematics::~LinkageKinematics(){}
+
+void LinkageKinematics::parameters(const HodographParameters& value){
+    bool geometry = value.radius != parameters_.radius
+                    || value.line_length != parameters_.line_length;
+    parameters_ = value;
+    if(geometry)
+        Rebuild();
+}
+
+void LinkageKinematics::mechanism(const MechanismSettings& value){
+    if(value == settings_)
+        return;
+    settings_ = value;
+    Rebuild();
+}
+
+void LinkageKinematics::Update(float time_delta){
+    ProfileScope scope("LinkageUpdate", Profiler::detailed());
+    PlanarLinkage& linkage = mechanism_.linkage;
+
+    line_error_length_ = parameters_.line_length
+                         + parameters_.error * noise_stream_.Next();
+    linkage.length(mechanism_.coupler, line_error_length_);
+
+    status_ = linkage.Solve(alpha_);
+    if(status_ == LinkageStatus::OK){
+        const Point2& tip = linkage.joint(mechanism_.crank).position;
+        position0_ = Vec3(PLANE_X, (float)tip.y, (float)tip.x);
+        sample_ = linkage.Sample(mechanism_.output,
+                                 parameters_.angular_velocity);
+        sample_.position.x = PLANE_X;
+    }else{
+        singular_steps_++;
+    }
+
+    UpdateAlpha(time_delta);
+    time_ += time_delta;
+    if(cache_enabled_)
+        hodograph_cache_.Push(sample_);
+}
+
+void LinkageKinematics::ResetCache(){
+    hodograph_cache_.Clear();
+    singular_steps_ = 0;
+}
+
+void LinkageKinematics::Rebuild(){
+    mechanism_ = CreateMechanism(settings_, parameters_, alpha_);
+}
+
+void LinkageKinematics::UpdateAlpha(float time_delta){
+    const double two_pi = 2 * M_PI;
+    alpha_ += parameters_.angular_velocity * time_delta;
+    if(alpha_ >= two_pi || alpha_ < 0){
+        alpha_ = std::fmod(alpha_, two_pi);
+        if(alpha_ < 0)
+            alpha_ += two_pi;
+    }
+}
@@ -0,0 +1,115 @@
+#include "linkage/linkage_mechanism.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/**
+ * Intersection of circles (a, ra) and (b, rb) left of the direction a->b.
+ * Circles that do not meet give the point on the segment between them
+ * that is closest to both, Solve then reports the missing assembly.
+ */
+Point2 IntersectCircles(const Point2& a, double ra,
+                        const Point2& b, double rb){
+    double dx = b.x - a.x;
+    double dy = b.y - a.y;
+    double d = std::sqrt(dx * dx + dy * dy);
+    if(d == 0)
+        return Point2(a.x, a.y + ra);
+
+    double along = (d * d + ra * ra - rb * rb) / (2 * d);
+    double across = std::sqrt(std::max(ra * ra - along * along, 0.0));
+    double ux = dx / d;
+    double uy = dy / d;
+    return Point2(a.x + along * ux - across * uy,
+                  a.y + along * uy + across * ux);
+}
+
+Point2 CrankTip(const HodographParameters& parameters, double alpha){
+    return Point2(parameters.radius * std::sin(alpha),
+                  parameters.radius * std::cos(alpha));
+}
+
+void AddSliderCrank(Mechanism& mechanism, const HodographParameters& parameters,
+                    double offset, double alpha){
+    PlanarLinkage& linkage = mechanism.linkage;
+    Point2 tip = CrankTip(parameters, alpha);
+    double height = tip.y - offset;
+    double reach = std::sqrt(std::max(
+            (double)parameters.line_length * parameters.line_length
+            - height * height, 0.0));
+
+    int center = linkage.AddFixed(0, 0);
+    mechanism.crank = linkage.AddCrank(center, parameters.radius);
+    mechanism.output = linkage.AddFree(tip.x + reach, offset);
+    mechanism.coupler = linkage.AddDistance(mechanism.crank, mechanism.output,
+                                            parameters.line_length);
+    linkage.AddSlider(mechanism.output, Point2(0, offset), Point2(1, 0));
+}
+
+void AddFourBar(Mechanism& mechanism, const MechanismSettings& settings,
+                const HodographParameters& parameters, double alpha){
+    PlanarLinkage& linkage = mechanism.linkage;
+    Point2 tip = CrankTip(parameters, alpha);
+    Point2 pivot(settings.ground, 0);
+    // Left of crank tip -> rocker pivot, above the ground line.
+    Point2 guess = IntersectCircles(tip, parameters.line_length,
+                                    pivot, settings.rocker);
+
+    int center = linkage.AddFixed(0, 0);
+    int rocker = linkage.AddFixed(pivot.x, pivot.y);
+    mechanism.crank = linkage.AddCrank(center, parameters.radius);
+    mechanism.output = linkage.AddFree(guess.x, guess.y);
+    mechanism.coupler = linkage.AddDistance(mechanism.crank, mechanism.output,
+                                            parameters.line_length);
+    linkage.AddDistance(rocker, mechanism.output, settings.rocker);
+}
+
+}
+
+const char* MechanismName(MechanismType type){
+    switch(type){
+        case MechanismType::CRANK_SLIDER:
+            return "Crank Slider";
+        case MechanismType::OFFSET_SLIDER_CRANK:
+            return "Offset Slider Crank";
+        case MechanismType::FOUR_BAR:
+            return "Four Bar";
+        case MechanismType::TWO_LOOP:
+            return "Two Loop";
+    }
+    return "";
+}
+
+Mechanism CreateMechanism(const MechanismSettings& settings,
+                          const HodographParameters& parameters,
+                          double alpha){
+    Mechanism mechanism;
+    switch(settings.type){
+        case MechanismType::CRANK_SLIDER:
+            AddSliderCrank(mechanism, parameters, 0, alpha);
+            break;
+        case MechanismType::OFFSET_SLIDER_CRANK:
+            AddSliderCrank(mechanism, parameters, settings.offset, alpha);
+            break;
+        case MechanismType::FOUR_BAR:
+            AddFourBar(mechanism, settings, parameters, alpha);
+            break;
+        case MechanismType::TWO_LOOP:{
+            AddFourBar(mechanism, settings, parameters, alpha);
+            PlanarLinkage& linkage = mechanism.linkage;
+            const Point2& joint = linkage.joint(mechanism.output).position;
+            double reach = std::sqrt(std::max(
+                    (double)settings.output_length * settings.output_length
+                    - joint.y * joint.y, 0.0));
+            int slider = linkage.AddFree(joint.x + reach, 0);
+            linkage.AddDistance(mechanism.output, slider,
+                                settings.output_length);
+            linkage.AddSlider(slider, Point2(0, 0), Point2(1, 0));
+            mechanism.output = slider;
+            break;
+        }
+    }
+    return mechanism;
+}
@@ -0,0 +1,382 @@
+#include "linkage/planar_linkage.h"
+
+#include <algorithm>
+#include <cmath>
+
+const int PlanarLinkage::MAX_JOINTS;
+const int PlanarLinkage::MAX_UNKNOWNS;
+const int PlanarLinkage::MAX_ITERATIONS;
+
+namespace {
+
+/**
+ * Pivots below this fraction of the largest Jacobian entry count as 0.
+ */
+const double SINGULAR_TOLERANCE = 1e-8;
+/**
+ * Residual tolerance relative to the squared longest link.
+ */
+const double RESIDUAL_TOLERANCE = 1e-12;
+
+Point2 operator-(const Point2& a, const Point2& b){
+    return Point2(a.x - b.x, a.y - b.y);
+}
+
+double Dot(const Point2& a, const Point2& b){
+    return a.x * b.x + a.y * b.y;
+}
+
+double WrapAngle(double angle){
+    angle = std::fmod(angle + M_PI, 2 * M_PI);
+    if(angle < 0)
+        angle += 2 * M_PI;
+    return angle - M_PI;
+}
+
+/**
+ * LU factorization with partial pivoting of the row major n x n matrix a,
+ * in place. Returns false if a is singular.
+ */
+bool Factor(double* a, int* pivots, int n){
+    double scale = 0;
+    for(int i = 0; i < n * n; i++)
+        scale = std::max(scale, std::fabs(a[i]));
+    double tiny = SINGULAR_TOLERANCE * scale;
+    if(scale == 0)
+        return n == 0;
+
+    for(int k = 0; k < n; k++){
+        int pivot = k;
+        for(int i = k + 1; i < n; i++){
+            if(std::fabs(a[i * n + k]) > std::fabs(a[pivot * n + k]))
+                pivot = i;
+        }
+        if(!(std::fabs(a[pivot * n + k]) > tiny))
+            return false;
+        pivots[k] = pivot;
+        if(pivot != k){
+            for(int j = 0; j < n; j++)
+                std::swap(a[k * n + j], a[pivot * n + j]);
+        }
+
+        double inverse = 1 / a[k * n + k];
+        for(int i = k + 1; i < n; i++){
+            double factor = a[i * n + k] *= inverse;
+            for(int j = k + 1; j < n; j++)
+                a[i * n + j] -= factor * a[k * n + j];
+        }
+    }
+    return true;
+}
+
+void SolveFactored(const double* a, const int* pivots, int n, double* b){
+    for(int k = 0; k < n; k++)
+        std::swap(b[k], b[pivots[k]]);
+    for(int i = 0; i < n; i++){
+        for(int j = 0; j < i; j++)
+            b[i] -= a[i * n + j] * b[j];
+    }
+    for(int i = n - 1; i >= 0; i--){
+        for(int j = i + 1; j < n; j++)
+            b[i] -= a[i * n + j] * b[j];
+        b[i] /= a[i * n + i];
+    }
+}
+
+}
+
+PlanarLinkage::PlanarLinkage() :
+        joint_count_(0),
+        constraint_count_(0),
+        unknown_count_(0),
+        alpha_(0),
+        solved_(false),
+        iterations_(0){}
+
+PlanarLinkage::~PlanarLinkage(){}
+
+int PlanarLinkage::AddFixed(double x, double y){
+    if(joint_count_ == MAX_JOINTS)
+        return -1;
+    LinkageJoint& joint = joints_[joint_count_];
+    joint = LinkageJoint();
+    joint.type = JointType::FIXED;
+    joint.position = Point2(x, y);
+    guesses_[joint_count_] = joint.position;
+    unknowns_[joint_count_] = -1;
+    return joint_count_++;
+}
+
+int PlanarLinkage::AddCrank(int center, double radius, double phase){
+    if(joint_count_ == MAX_JOINTS || !is_joint(center))
+        return -1;
+    LinkageJoint& joint = joints_[joint_count_];
+    joint = LinkageJoint();
+    joint.type = JointType::CRANK;
+    joint.center = center;
+    joint.radius = radius;
+    joint.phase = phase;
+    unknowns_[joint_count_] = -1;
+    int index = joint_count_++;
+    UpdateCranks(alpha_);
+    return index;
+}
+
+int PlanarLinkage::AddFree(double x, double y){
+    if(joint_count_ == MAX_JOINTS || unknown_count_ + 2 > MAX_UNKNOWNS)
+        return -1;
+    LinkageJoint& joint = joints_[joint_count_];
+    joint = LinkageJoint();
+    joint.type = JointType::FREE;
+    joint.position = Point2(x, y);
+    guesses_[joint_count_] = joint.position;
+    unknowns_[joint_count_] = unknown_count_;
+    unknown_count_ += 2;
+    return joint_count_++;
+}
+
+int PlanarLinkage::AddDistance(int a, int b, double length){
+    if(constraint_count_ == MAX_UNKNOWNS || !is_joint(a) || !is_joint(b))
+        return -1;
+    LinkageConstraint& constraint = constraints_[constraint_count_];
+    constraint = LinkageConstraint();
+    constraint.type = ConstraintType::DISTANCE;
+    constraint.a = a;
+    constraint.b = b;
+    constraint.length = length;
+    return constraint_count_++;
+}
+
+int PlanarLinkage::AddSlider(int joint, const Point2& origin,
+                             const Point2& direction){
+    if(constraint_count_ == MAX_UNKNOWNS || !is_joint(joint))
+        return -1;
+    LinkageConstraint& constraint = constraints_[constraint_count_];
+    constraint = LinkageConstraint();
+    constraint.type = ConstraintType::SLIDER;
+    constraint.a = joint;
+    constraint.origin = origin;
+    double length = std::sqrt(Dot(direction, direction));
+    constraint.normal = Point2(-direction.y / length, direction.x / length);
+    return constraint_count_++;
+}
+
+LinkageStatus PlanarLinkage::Solve(double alpha){
+    iterations_ = 0;
+    if(!is_square() || unknown_count_ > MAX_UNKNOWNS)
+        return LinkageStatus::SINGULAR;
+
+    std::copy(joints_, joints_ + joint_count_, previous_);
+    UpdateCranks(alpha);
+    Predict(alpha);
+
+    const int n = unknown_count_;
+    double residual[MAX_UNKNOWNS];
+    double jacobian[MAX_UNKNOWNS * MAX_UNKNOWNS];
+    int pivots[MAX_UNKNOWNS];
+    double tolerance = Tolerance();
+
+    LinkageStatus status = LinkageStatus::OK;
+    while(true){
+        Evaluate(residual, jacobian);
+        double norm = 0;
+        for(int i = 0; i < n; i++)
+            norm = std::max(norm, std::fabs(residual[i]));
+        bool factored = Factor(jacobian, pivots, n);
+
+        if(!factored){
+            status = LinkageStatus::SINGULAR;
+            break;
+        }
+        if(norm <= tolerance)
+            break;
+        if(iterations_ == MAX_ITERATIONS || !std::isfinite(norm)){
+            status = LinkageStatus::NOT_CONVERGED;
+            break;
+        }
+
+        SolveFactored(jacobian, pivots, n, residual);
+        for(int j = 0; j < joint_count_; j++){
+            int unknown = unknowns_[j];
+            if(unknown < 0)
+                continue;
+            joints_[j].position.x -= residual[unknown];
+            joints_[j].position.y -= residual[unknown + 1];
+        }
+        iterations_++;
+    }
+
+    if(status != LinkageStatus::OK){
+        std::copy(previous_, previous_ + joint_count_, joints_);
+        return status;
+    }
+    UpdateDerivatives(jacobian, pivots);
+    alpha_ = alpha;
+    solved_ = true;
+    return status;
+}
+
+void PlanarLinkage::Reset(){
+    solved_ = false;
+}
+
+HodographSample PlanarLinkage::Sample(int joint,
+                                      double angular_velocity) const {
+    const LinkageJoint& source = joints_[joint];
+    double w = angular_velocity;
+    HodographSample sample;
+    sample.position = Vec3(0, (float)source.position.y,
+                           (float)source.position.x);
+    sample.velocity = Vec3(0, (float)(w * source.derivative.y),
+                           (float)(w * source.derivative.x));
+    sample.acceleration = Vec3(0, (float)(w * w * source.second_derivative.y),
+                               (float)(w * w * source.second_derivative.x));
+    return sample;
+}
+
+void PlanarLinkage::UpdateCranks(double alpha){
+    for(int j = 0; j < joint_count_; j++){
+        LinkageJoint& joint = joints_[j];
+        if(joint.type != JointType::CRANK)
+            continue;
+        const Point2& center = joints_[joint.center].position;
+        double angle = alpha + joint.phase;
+        double s = std::sin(angle);
+        double c = std::cos(angle);
+        double r = joint.radius;
+        joint.position = Point2(center.x + r * s, center.y + r * c);
+        joint.derivative = Point2(r * c, -r * s);
+        joint.second_derivative = Point2(-r * s, -r * c);
+    }
+}
+
+void PlanarLinkage::Predict(double alpha){
+    if(!solved_){
+        for(int j = 0; j < joint_count_; j++){
+            if(joints_[j].type != JointType::FREE)
+                continue;
+            joints_[j].position = guesses_[j];
+            joints_[j].derivative = Point2();
+            joints_[j].second_derivative = Point2();
+        }
+        return;
+    }
+
+    // Second order Taylor step along the previous motion.
+    double delta = WrapAngle(alpha - alpha_);
+    double half_delta_sqr = 0.5 * delta * delta;
+    for(int j = 0; j < joint_count_; j++){
+        LinkageJoint& joint = joints_[j];
+        if(joint.type != JointType::FREE)
+            continue;
+        joint.position.x += joint.derivative.x * delta
+                            + joint.second_derivative.x * half_delta_sqr;
+        joint.position.y += joint.derivative.y * delta
+                            + joint.second_derivative.y * half_delta_sqr;
+    }
+}
+
+void PlanarLinkage::Evaluate(double* residual, double* jacobian) const {
+    const int n = unknown_count_;
+    std::fill(jacobian, jacobian + n * n, 0.0);
+    for(int c = 0; c < constraint_count_; c++){
+        const LinkageConstraint& constraint = constraints_[c];
+        const Point2& a = joints_[constraint.a].position;
+        if(constraint.type == ConstraintType::DISTANCE){
+            Point2 difference = a - joints_[constraint.b].position;
+            residual[c] = Dot(difference, difference)
+                          - constraint.length * constraint.length;
+        }else{
+            residual[c] = Dot(constraint.normal, a - constraint.origin);
+        }
+
+        Point2 gradient_a;
+        Point2 gradient_b;
+        Gradients(constraint, gradient_a, gradient_b);
+        AddColumn(jacobian + c * n, constraint.a, gradient_a);
+        if(constraint.type == ConstraintType::DISTANCE)
+            AddColumn(jacobian + c * n, constraint.b, gradient_b);
+    }
+}
+
+void PlanarLinkage::Gradients(const LinkageConstraint& constraint,
+                              Point2& gradient_a, Point2& gradient_b) const {
+    if(constraint.type == ConstraintType::DISTANCE){
+        Point2 difference = joints_[constraint.a].position
+                            - joints_[constraint.b].position;
+        gradient_a = Point2(2 * difference.x, 2 * difference.y);
+        gradient_b = Point2(-2 * difference.x, -2 * difference.y);
+    }else{
+        gradient_a = constraint.normal;
+        gradient_b = Point2();
+    }
+}
+
+double PlanarLinkage::Tolerance() const {
+    double scale = 1;
+    for(int c = 0; c < constraint_count_; c++)
+        scale = std::max(scale, constraints_[c].length);
+    return RESIDUAL_TOLERANCE * scale * scale;
+}
+
+void PlanarLinkage::UpdateDerivatives(const double* factors,
+                                      const int* pivots){
+    const int n = unknown_count_;
+    double first[MAX_UNKNOWNS];
+    double second[MAX_UNKNOWNS];
+    Point2 gradients_a[MAX_UNKNOWNS];
+    Point2 gradients_b[MAX_UNKNOWNS];
+
+    for(int c = 0; c < constraint_count_; c++){
+        const LinkageConstraint& constraint = constraints_[c];
+        Gradients(constraint, gradients_a[c], gradients_b[c]);
+        first[c] = -Known(constraint.a, gradients_a[c], false)
+                   - Known(constraint.b, gradients_b[c], false);
+    }
+    SolveFactored(factors, pivots, n, first);
+    for(int j = 0; j < joint_count_; j++){
+        int unknown = unknowns_[j];
+        if(unknown >= 0)
+            joints_[j].derivative = Point2(first[unknown], first[unknown + 1]);
+    }
+
+    // gamma: the part of the second derivative of a constraint that does
+    // not depend on the second derivatives of the joints.
+    for(int c = 0; c < constraint_count_; c++){
+        const LinkageConstraint& constraint = constraints_[c];
+        double gamma = 0;
+        if(constraint.type == ConstraintType::DISTANCE){
+            Point2 difference = joints_[constraint.a].derivative
+                                - joints_[constraint.b].derivative;
+            gamma = 2 * Dot(difference, difference);
+        }
+        second[c] = -Known(constraint.a, gradients_a[c], true)
+                    - Known(constraint.b, gradients_b[c], true) - gamma;
+    }
+    SolveFactored(factors, pivots, n, second);
+    for(int j = 0; j < joint_count_; j++){
+        int unknown = unknowns_[j];
+        if(unknown >= 0){
+            joints_[j].second_derivative = Point2(second[unknown],
+                                                  second[unknown + 1]);
+        }
+    }
+}
+
+void PlanarLinkage::AddColumn(double* row, int joint,
+                              const Point2& gradient) const {
+    int unknown = unknowns_[joint];
+    if(unknown < 0)
+        return;
+    row[unknown] += gradient.x;
+    row[unknown + 1] += gradient.y;
+}
+
+double PlanarLinkage::Known(int joint, const Point2& gradient,
+                            bool second) const {
+    if(joint < 0 || unknowns_[joint] >= 0)
+        return 0;
+    const LinkageJoint& source = joints_[joint];
+    return Dot(gradient, second ? source.second_derivative
+                                : source.derivative);
+}
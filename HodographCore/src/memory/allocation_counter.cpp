@@ -0,0 +1,43 @@
+#include "memory/allocation_counter.h"
+
+namespace {
+
+thread_local AllocationStats thread_stats = {0, 0};
+bool hooks_enabled = false;
+
+}
+
+AllocationCounter::AllocationCounter(){
+    Reset();
+}
+
+AllocationCounter::~AllocationCounter(){}
+
+unsigned long long AllocationCounter::count() const {
+    return thread_stats.count - start_.count;
+}
+
+unsigned long long AllocationCounter::bytes() const {
+    return thread_stats.bytes - start_.bytes;
+}
+
+void AllocationCounter::Reset(){
+    start_ = thread_stats;
+}
+
+AllocationStats AllocationCounter::ThreadStats(){
+    return thread_stats;
+}
+
+bool AllocationCounter::enabled(){
+    return hooks_enabled;
+}
+
+void AllocationCounter::Enable(){
+    hooks_enabled = true;
+}
+
+void AllocationCounter::Record(std::size_t size){
+    thread_stats.count++;
+    thread_stats.bytes += size;
+}
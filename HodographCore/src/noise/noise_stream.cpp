@@ -0,0 +1,387 @@
+#include "noise/noise_stream.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+const std::size_t NoiseStream::BUFFER_SIZE;
+
+namespace {
+
+const uint32_t PHILOX_M0 = 0xD2511F53;
+const uint32_t PHILOX_M1 = 0xCD9E8D57;
+const uint32_t PHILOX_W0 = 0x9E3779B9;
+const uint32_t PHILOX_W1 = 0xBB67AE85;
+const int PHILOX_ROUNDS = 10;
+
+const float PI = 3.14159265358979323846f;
+const float SQRT_2 = 1.41421356237309504880f;
+const float UNIFORM_SCALE = 1.0f / 16777216.0f;
+
+// Cephes logf polynomial.
+const float LOG_P0 = 7.0376836292E-2f;
+const float LOG_P1 = -1.1514610310E-1f;
+const float LOG_P2 = 1.1676998740E-1f;
+const float LOG_P3 = -1.2420140846E-1f;
+const float LOG_P4 = 1.4249322787E-1f;
+const float LOG_P5 = -1.6668057665E-1f;
+const float LOG_P6 = 2.0000714765E-1f;
+const float LOG_P7 = -2.4999993993E-1f;
+const float LOG_P8 = 3.3333331174E-1f;
+const float LOG_Q1 = -2.12194440E-4f;
+const float LOG_Q2 = 0.693359375f;
+
+// Taylor polynomials of sin and cos on [-pi/2, pi/2].
+const float SIN_C1 = -1.0f / 6.0f;
+const float SIN_C2 = 1.0f / 120.0f;
+const float SIN_C3 = -1.0f / 5040.0f;
+const float SIN_C4 = 1.0f / 362880.0f;
+const float SIN_C5 = -1.0f / 39916800.0f;
+const float COS_C1 = -1.0f / 2.0f;
+const float COS_C2 = 1.0f / 24.0f;
+const float COS_C3 = -1.0f / 720.0f;
+const float COS_C4 = 1.0f / 40320.0f;
+const float COS_C5 = -1.0f / 3628800.0f;
+const float COS_C6 = 1.0f / 479001600.0f;
+
+/*
+ * Both paths below evaluate the same float operations in the same order,
+ * so a seed produces identical numbers with and without SSE2.
+ */
+
+void Philox4x32(uint64_t block, uint64_t stream, uint64_t seed,
+                uint32_t result[4]){
+    uint32_t c0 = (uint32_t)block;
+    uint32_t c1 = (uint32_t)(block >> 32);
+    uint32_t c2 = (uint32_t)stream;
+    uint32_t c3 = (uint32_t)(stream >> 32);
+    uint32_t k0 = (uint32_t)seed;
+    uint32_t k1 = (uint32_t)(seed >> 32);
+
+    for(int round = 0; round < PHILOX_ROUNDS; round++){
+        uint64_t product0 = (uint64_t)PHILOX_M0 * c0;
+        uint64_t product1 = (uint64_t)PHILOX_M1 * c2;
+        uint32_t hi0 = (uint32_t)(product0 >> 32);
+        uint32_t lo0 = (uint32_t)product0;
+        uint32_t hi1 = (uint32_t)(product1 >> 32);
+        uint32_t lo1 = (uint32_t)product1;
+
+        c0 = hi1 ^ c1 ^ k0;
+        c1 = lo1;
+        c2 = hi0 ^ c3 ^ k1;
+        c3 = lo0;
+
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    result[0] = c0;
+    result[1] = c1;
+    result[2] = c2;
+    result[3] = c3;
+}
+
+/**
+ * Uniform in (0, 1), never 0 so the logarithm stays finite.
+ */
+float Uniform(uint32_t bits){
+    return ((float)(int32_t)(bits >> 8) + 0.5f) * UNIFORM_SCALE;
+}
+
+/**
+ * Natural logarithm of x > 0, branch-free.
+ */
+float FastLog(float x){
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    float exponent = (float)((int32_t)(bits >> 23) - 127);
+    bits = (bits & 0x007FFFFF) | 0x3F800000;
+    float mantissa;
+    std::memcpy(&mantissa, &bits, sizeof(mantissa));
+
+    // Keep the mantissa in [sqrt(1/2), sqrt(2)).
+    if(mantissa > SQRT_2){
+        mantissa = mantissa * 0.5f;
+        exponent = exponent + 1.0f;
+    }
+
+    float f = mantissa - 1.0f;
+    float z = f * f;
+    float y = LOG_P0;
+    y = y * f + LOG_P1;
+    y = y * f + LOG_P2;
+    y = y * f + LOG_P3;
+    y = y * f + LOG_P4;
+    y = y * f + LOG_P5;
+    y = y * f + LOG_P6;
+    y = y * f + LOG_P7;
+    y = y * f + LOG_P8;
+    y = y * f * z;
+    y = y + LOG_Q1 * exponent;
+    y = y - 0.5f * z;
+    return (f + y) + LOG_Q2 * exponent;
+}
+
+/**
+ * Box-Muller: u1, u2 -> r cos(t), r sin(t), r = sqrt(-2 ln u1).
+ * The angle pi * (2 u2 - 1) is taken from its half angle, where short
+ * polynomials are accurate to float precision.
+ */
+void BoxMuller(uint32_t bits1, uint32_t bits2, float& n0, float& n1){
+    float radius = std::sqrt(-2.0f * FastLog(Uniform(bits1)));
+
+    float h = (Uniform(bits2) * 2.0f - 1.0f) * (0.5f * PI);
+    float h2 = h * h;
+    float s = SIN_C5;
+    s = s * h2 + SIN_C4;
+    s = s * h2 + SIN_C3;
+    s = s * h2 + SIN_C2;
+    s = s * h2 + SIN_C1;
+    s = s * h2 + 1.0f;
+    s = s * h;
+    float c = COS_C6;
+    c = c * h2 + COS_C5;
+    c = c * h2 + COS_C4;
+    c = c * h2 + COS_C3;
+    c = c * h2 + COS_C2;
+    c = c * h2 + COS_C1;
+    c = c * h2 + 1.0f;
+
+    n0 = radius * (c * c - s * s);
+    n1 = radius * (2.0f * (s * c));
+}
+
+void GenerateBlocksScalar(uint64_t seed, uint64_t stream, uint64_t block,
+                          std::size_t block_count, float* normals){
+    for(std::size_t b = 0; b < block_count; b++){
+        uint32_t bits[4];
+        Philox4x32(block + b, stream, seed, bits);
+        BoxMuller(bits[0], bits[1], normals[4 * b], normals[4 * b + 1]);
+        BoxMuller(bits[2], bits[3], normals[4 * b + 2], normals[4 * b + 3]);
+    }
+}
+
+#if defined(__SSE2__)
+
+/**
+ * 32x32 -> 64 bit products of all four lanes, split in high and low words.
+ */
+inline void MulHiLo(__m128i a, __m128i m, __m128i& hi, __m128i& lo){
+    const __m128i low_words = _mm_set_epi32(0, -1, 0, -1);
+    __m128i even = _mm_mul_epu32(a, m);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), m);
+    lo = _mm_or_si128(_mm_and_si128(even, low_words),
+                      _mm_slli_epi64(odd, 32));
+    hi = _mm_or_si128(_mm_srli_epi64(even, 32),
+                      _mm_andnot_si128(low_words, odd));
+}
+
+inline __m128 UniformSIMD(__m128i bits){
+    __m128 u = _mm_cvtepi32_ps(_mm_srli_epi32(bits, 8));
+    return _mm_mul_ps(_mm_add_ps(u, _mm_set1_ps(0.5f)),
+                      _mm_set1_ps(UNIFORM_SCALE));
+}
+
+inline __m128 Horner(__m128 y, __m128 x, float c){
+    return _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(c));
+}
+
+inline __m128 FastLogSIMD(__m128 x){
+    __m128i bits = _mm_castps_si128(x);
+    __m128 exponent = _mm_cvtepi32_ps(
+            _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+    bits = _mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)),
+                        _mm_set1_epi32(0x3F800000));
+    __m128 mantissa = _mm_castsi128_ps(bits);
+
+    __m128 high = _mm_cmpgt_ps(mantissa, _mm_set1_ps(SQRT_2));
+    mantissa = _mm_or_ps(
+            _mm_and_ps(high, _mm_mul_ps(mantissa, _mm_set1_ps(0.5f))),
+            _mm_andnot_ps(high, mantissa));
+    exponent = _mm_or_ps(
+            _mm_and_ps(high, _mm_add_ps(exponent, _mm_set1_ps(1.0f))),
+            _mm_andnot_ps(high, exponent));
+
+    __m128 f = _mm_sub_ps(mantissa, _mm_set1_ps(1.0f));
+    __m128 z = _mm_mul_ps(f, f);
+    __m128 y = _mm_set1_ps(LOG_P0);
+    y = Horner(y, f, LOG_P1);
+    y = Horner(y, f, LOG_P2);
+    y = Horner(y, f, LOG_P3);
+    y = Horner(y, f, LOG_P4);
+    y = Horner(y, f, LOG_P5);
+    y = Horner(y, f, LOG_P6);
+    y = Horner(y, f, LOG_P7);
+    y = Horner(y, f, LOG_P8);
+    y = _mm_mul_ps(_mm_mul_ps(y, f), z);
+    y = _mm_add_ps(y, _mm_mul_ps(_mm_set1_ps(LOG_Q1), exponent));
+    y = _mm_sub_ps(y, _mm_mul_ps(_mm_set1_ps(0.5f), z));
+    return _mm_add_ps(_mm_add_ps(f, y),
+                      _mm_mul_ps(_mm_set1_ps(LOG_Q2), exponent));
+}
+
+inline void BoxMullerSIMD(__m128i bits1, __m128i bits2,
+                          __m128& n0, __m128& n1){
+    __m128 radius = _mm_sqrt_ps(_mm_mul_ps(_mm_set1_ps(-2.0f),
+                                           FastLogSIMD(UniformSIMD(bits1))));
+
+    __m128 h = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(UniformSIMD(bits2),
+                                                _mm_set1_ps(2.0f)),
+                                     _mm_set1_ps(1.0f)),
+                          _mm_set1_ps(0.5f * PI));
+    __m128 h2 = _mm_mul_ps(h, h);
+    __m128 s = _mm_set1_ps(SIN_C5);
+    s = Horner(s, h2, SIN_C4);
+    s = Horner(s, h2, SIN_C3);
+    s = Horner(s, h2, SIN_C2);
+    s = Horner(s, h2, SIN_C1);
+    s = Horner(s, h2, 1.0f);
+    s = _mm_mul_ps(s, h);
+    __m128 c = _mm_set1_ps(COS_C6);
+    c = Horner(c, h2, COS_C5);
+    c = Horner(c, h2, COS_C4);
+    c = Horner(c, h2, COS_C3);
+    c = Horner(c, h2, COS_C2);
+    c = Horner(c, h2, COS_C1);
+    c = Horner(c, h2, 1.0f);
+
+    n0 = _mm_mul_ps(radius, _mm_sub_ps(_mm_mul_ps(c, c), _mm_mul_ps(s, s)));
+    n1 = _mm_mul_ps(radius, _mm_mul_ps(_mm_set1_ps(2.0f), _mm_mul_ps(s, c)));
+}
+
+/**
+ * Four Philox blocks per iteration, one block per lane.
+ */
+std::size_t GenerateBlocksSIMD(uint64_t seed, uint64_t stream, uint64_t block,
+                               std::size_t block_count, float* normals){
+    const __m128i m0 = _mm_set1_epi32((int)PHILOX_M0);
+    const __m128i m1 = _mm_set1_epi32((int)PHILOX_M1);
+
+    std::size_t b = 0;
+    for(; b + 4 <= block_count; b += 4){
+        uint64_t first = block + b;
+        __m128i c0 = _mm_set_epi32((int)(uint32_t)(first + 3),
+                                   (int)(uint32_t)(first + 2),
+                                   (int)(uint32_t)(first + 1),
+                                   (int)(uint32_t)first);
+        __m128i c1 = _mm_set_epi32((int)(uint32_t)((first + 3) >> 32),
+                                   (int)(uint32_t)((first + 2) >> 32),
+                                   (int)(uint32_t)((first + 1) >> 32),
+                                   (int)(uint32_t)(first >> 32));
+        __m128i c2 = _mm_set1_epi32((int)(uint32_t)stream);
+        __m128i c3 = _mm_set1_epi32((int)(uint32_t)(stream >> 32));
+        uint32_t k0 = (uint32_t)seed;
+        uint32_t k1 = (uint32_t)(seed >> 32);
+
+        for(int round = 0; round < PHILOX_ROUNDS; round++){
+            __m128i hi0, lo0, hi1, lo1;
+            MulHiLo(c0, m0, hi0, lo0);
+            MulHiLo(c2, m1, hi1, lo1);
+
+            c0 = _mm_xor_si128(_mm_xor_si128(hi1, c1),
+                               _mm_set1_epi32((int)k0));
+            c1 = lo1;
+            c2 = _mm_xor_si128(_mm_xor_si128(hi0, c3),
+                               _mm_set1_epi32((int)k1));
+            c3 = lo0;
+
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+
+        __m128 n0, n1, n2, n3;
+        BoxMullerSIMD(c0, c1, n0, n1);
+        BoxMullerSIMD(c2, c3, n2, n3);
+
+        // Lanes hold blocks, memory wants the four normals of each block.
+        _MM_TRANSPOSE4_PS(n0, n1, n2, n3);
+        _mm_storeu_ps(normals + 4 * b, n0);
+        _mm_storeu_ps(normals + 4 * b + 4, n1);
+        _mm_storeu_ps(normals + 4 * b + 8, n2);
+        _mm_storeu_ps(normals + 4 * b + 12, n3);
+    }
+    return b;
+}
+
+#else
+
+std::size_t GenerateBlocksSIMD(uint64_t, uint64_t, uint64_t,
+                               std::size_t, float*){
+    return 0;
+}
+
+#endif
+
+void GenerateBlocks(uint64_t seed, uint64_t stream, uint64_t block,
+                    std::size_t block_count, float* normals){
+    std::size_t done = GenerateBlocksSIMD(seed, stream, block, block_count,
+                                          normals);
+    GenerateBlocksScalar(seed, stream, block + done, block_count - done,
+                         normals + 4 * done);
+}
+
+}
+
+NoiseStream::NoiseStream(uint64_t seed, uint64_t stream){
+    Reset(seed, stream);
+}
+
+NoiseStream::~NoiseStream(){}
+
+void NoiseStream::Reset(uint64_t seed, uint64_t stream){
+    seed_ = seed;
+    stream_ = stream;
+    Seek(0);
+}
+
+void NoiseStream::Seek(uint64_t counter){
+    buffer_start_ = counter;
+    Generate(seed_, stream_, buffer_start_, buffer_, BUFFER_SIZE);
+    buffer_position_ = 0;
+}
+
+void NoiseStream::Fill(float* normals, std::size_t count){
+    // Serve what is left in the buffer, generate the rest in place.
+    std::size_t buffered = std::min(count, BUFFER_SIZE - buffer_position_);
+    std::copy(buffer_ + buffer_position_,
+              buffer_ + buffer_position_ + buffered, normals);
+    buffer_position_ += buffered;
+    if(buffered == count)
+        return;
+
+    uint64_t start = counter();
+    Generate(seed_, stream_, start, normals + buffered, count - buffered);
+    Seek(start + (count - buffered));
+}
+
+void NoiseStream::Refill(){
+    Seek(buffer_start_ + BUFFER_SIZE);
+}
+
+void NoiseStream::Generate(uint64_t seed, uint64_t stream, uint64_t counter,
+                           float* normals, std::size_t count){
+    float block_normals[4];
+    std::size_t i = 0;
+
+    // Leading partial block.
+    if(counter % 4 != 0 && count > 0){
+        GenerateBlocks(seed, stream, counter / 4, 1, block_normals);
+        for(uint64_t j = counter % 4; j < 4 && i < count; j++)
+            normals[i++] = block_normals[j];
+    }
+
+    uint64_t block = (counter + i) / 4;
+    std::size_t full_blocks = (count - i) / 4;
+    GenerateBlocks(seed, stream, block, full_blocks, normals + i);
+    i += 4 * full_blocks;
+    block += full_blocks;
+
+    if(i < count){
+        GenerateBlocks(seed, stream, block, 1, block_normals);
+        for(int j = 0; i < count; j++)
+            normals[i++] = block_normals[j];
+    }
+}
@@ -0,0 +1,222 @@
+#include "profiling/profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+const std::size_t Profiler::BUFFER_CAPACITY;
+std::atomic<bool> Profiler::enabled_(false);
+std::atomic<bool> Profiler::detailed_(false);
+
+namespace {
+
+struct ProfileSlot{
+    std::atomic<const char*> name;
+    std::atomic<uint64_t> begin;
+    std::atomic<uint64_t> end;
+};
+
+/**
+ * Written by its thread only. head counts all events ever recorded and is
+ * published after the slot, readers drop slots the writer may be reusing.
+ */
+struct ProfileBuffer{
+    ProfileBuffer(unsigned int thread) :
+            thread(thread),
+            head(0),
+            slots(new ProfileSlot[Profiler::BUFFER_CAPACITY]){}
+
+    unsigned int thread;
+    std::string name;
+    std::atomic<uint64_t> head;
+    std::unique_ptr<ProfileSlot[]> slots;
+};
+
+struct ProfileRegistry{
+    ProfileRegistry() : cleared(0){}
+
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ProfileBuffer>> buffers;
+    std::atomic<uint64_t> cleared;
+};
+
+ProfileRegistry& Registry(){
+    static ProfileRegistry registry;
+    return registry;
+}
+
+/**
+ * Buffers outlive their threads, the registry keeps them for Collect.
+ */
+ProfileBuffer& ThreadBuffer(){
+    thread_local std::shared_ptr<ProfileBuffer> buffer;
+    if(!buffer){
+        ProfileRegistry& registry = Registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        buffer = std::make_shared<ProfileBuffer>(
+                (unsigned int)registry.buffers.size());
+        registry.buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+float Percentile(std::vector<uint64_t>& durations, float fraction){
+    std::size_t n = (std::size_t)(fraction * (durations.size() - 1) + 0.5f);
+    std::nth_element(durations.begin(), durations.begin() + n,
+                     durations.end());
+    return durations[n] / 1000.0f;
+}
+
+bool NameLess(const ProfileEvent& a, const ProfileEvent& b){
+    return strcmp(a.name, b.name) < 0;
+}
+
+}
+
+uint64_t Profiler::Now(){
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Profiler::Record(const char* name, uint64_t begin, uint64_t end){
+    ProfileBuffer& buffer = ThreadBuffer();
+    uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    ProfileSlot& slot = buffer.slots[head % BUFFER_CAPACITY];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.begin.store(begin, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::SetThreadName(const std::string& name){
+    ProfileBuffer& buffer = ThreadBuffer();
+    std::lock_guard<std::mutex> lock(Registry().mutex);
+    buffer.name = name;
+}
+
+void Profiler::Collect(std::vector<ProfileEvent>& events, uint64_t since){
+    ProfileRegistry& registry = Registry();
+    since = std::max(since, registry.cleared.load());
+
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for(std::size_t b = 0; b < registry.buffers.size(); b++){
+        ProfileBuffer& buffer = *registry.buffers[b];
+        std::size_t first_event = events.size();
+
+        uint64_t head = buffer.head.load(std::memory_order_acquire);
+        uint64_t first = head > BUFFER_CAPACITY ? head - BUFFER_CAPACITY : 0;
+        for(uint64_t i = first; i < head; i++){
+            ProfileSlot& slot = buffer.slots[i % BUFFER_CAPACITY];
+            ProfileEvent event;
+            event.name = slot.name.load(std::memory_order_relaxed);
+            event.begin = slot.begin.load(std::memory_order_relaxed);
+            event.end = slot.end.load(std::memory_order_relaxed);
+            event.thread = buffer.thread;
+            events.push_back(event);
+        }
+
+        // Slots up to the one being written now may hold newer events.
+        uint64_t new_head = buffer.head.load(std::memory_order_acquire);
+        uint64_t valid = new_head >= BUFFER_CAPACITY
+                         ? new_head - BUFFER_CAPACITY + 1 : 0;
+        std::size_t overwritten = valid > first
+                                  ? (std::size_t)std::min(valid - first,
+                                                          head - first) : 0;
+        events.erase(events.begin() + first_event,
+                     events.begin() + first_event + overwritten);
+    }
+
+    events.erase(std::remove_if(events.begin(), events.end(),
+                                [since](const ProfileEvent& event){
+                                    return event.begin < since;
+                                }),
+                 events.end());
+}
+
+std::vector<ProfileThread> Profiler::Threads(){
+    ProfileRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    std::vector<ProfileThread> threads;
+    for(std::size_t b = 0; b < registry.buffers.size(); b++){
+        ProfileThread thread;
+        thread.id = registry.buffers[b]->thread;
+        thread.name = registry.buffers[b]->name;
+        threads.push_back(thread);
+    }
+    return threads;
+}
+
+void Profiler::Clear(){
+    Registry().cleared.store(Now());
+}
+
+void ComputeStageStatistics(const std::vector<ProfileEvent>& events,
+                            std::vector<StageStatistics>& statistics){
+    statistics.clear();
+
+    std::vector<ProfileEvent> sorted(events);
+    std::stable_sort(sorted.begin(), sorted.end(), NameLess);
+
+    std::vector<uint64_t> durations;
+    std::size_t begin = 0;
+    while(begin < sorted.size()){
+        std::size_t end = begin;
+        durations.clear();
+        while(end < sorted.size()
+              && strcmp(sorted[end].name, sorted[begin].name) == 0){
+            durations.push_back(sorted[end].end - sorted[end].begin);
+            end++;
+        }
+
+        StageStatistics stage;
+        stage.name = sorted[begin].name;
+        stage.count = durations.size();
+        stage.max = *std::max_element(durations.begin(), durations.end())
+                    / 1000.0f;
+        stage.p50 = Percentile(durations, 0.5f);
+        stage.p99 = Percentile(durations, 0.99f);
+        statistics.push_back(stage);
+
+        begin = end;
+    }
+}
+
+bool WriteChromeTrace(const std::string& path,
+                      const std::vector<ProfileEvent>& events,
+                      const std::vector<ProfileThread>& threads){
+    FILE* file = fopen(path.c_str(), "w");
+    if(!file)
+        return false;
+
+    uint64_t origin = UINT64_MAX;
+    for(std::size_t i = 0; i < events.size(); i++)
+        origin = std::min(origin, events[i].begin);
+
+    fprintf(file, "{\"traceEvents\":[");
+    bool first = true;
+    for(std::size_t i = 0; i < threads.size(); i++){
+        if(threads[i].name.empty())
+            continue;
+        fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\","
+                "\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",", threads[i].id, threads[i].name.c_str());
+        first = false;
+    }
+    for(std::size_t i = 0; i < events.size(); i++){
+        const ProfileEvent& event = events[i];
+        fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,"
+                "\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                first ? "" : ",", event.name, event.thread,
+                (event.begin - origin) / 1000.0,
+                (event.end - event.begin) / 1000.0);
+        first = false;
+    }
+    fprintf(file, "\n],\"displayTimeUnit\":\"ns\"}\n");
+
+    bool written = !ferror(file);
+    return fclose(file) == 0 && written;
+}
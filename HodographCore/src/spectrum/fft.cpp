@@ -0,0 +1,68 @@
+#include "spectrum/fft.h"
+
+#include <cmath>
+
+bool IsPowerOfTwo(std::size_t n){
+    return n > 0 && (n & (n - 1)) == 0;
+}
+
+void FftRadix2(std::complex<float>* data, std::size_t n){
+    // Bit reversal permutation.
+    for(std::size_t i = 1, j = 0; i < n; i++){
+        std::size_t bit = n >> 1;
+        for(; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if(i < j)
+            std::swap(data[i], data[j]);
+    }
+
+    for(std::size_t length = 2; length <= n; length <<= 1){
+        std::complex<double> step = std::polar(1.0, -2 * M_PI / length);
+        std::size_t half = length / 2;
+        for(std::size_t start = 0; start < n; start += length){
+            std::complex<double> twiddle = 1;
+            for(std::size_t k = 0; k < half; k++){
+                std::complex<float> w((float)twiddle.real(),
+                                      (float)twiddle.imag());
+                std::complex<float> even = data[start + k];
+                std::complex<float> odd = data[start + k + half] * w;
+                data[start + k] = even + odd;
+                data[start + k + half] = even - odd;
+                twiddle *= step;
+            }
+        }
+    }
+}
+
+bool ComputeAmplitudeSpectrum(const RingView<float>& samples, std::size_t n,
+                              std::vector<std::complex<float>>& scratch,
+                              std::vector<float>& amplitudes){
+    if(!IsPowerOfTwo(n) || (std::size_t)samples.size < n)
+        return false;
+
+    int first = samples.size - (int)n;
+    double sum = 0;
+    for(std::size_t i = 0; i < n; i++)
+        sum += samples[first + (int)i];
+    float mean = (float)(sum / n);
+
+    // The mean is removed first, otherwise the window leaks it into bin 1.
+    scratch.resize(n);
+    float window_sum = 0;
+    for(std::size_t i = 0; i < n; i++){
+        float window = 0.5f - 0.5f * cosf(2 * (float)M_PI * i / n);
+        scratch[i] = (samples[first + (int)i] - mean) * window;
+        window_sum += window;
+    }
+
+    FftRadix2(scratch.data(), n);
+
+    amplitudes.resize(n / 2 + 1);
+    amplitudes[0] = std::abs(mean);
+    for(std::size_t k = 1; k <= n / 2; k++){
+        float scale = (k == n / 2 ? 1.0f : 2.0f) / window_sum;
+        amplitudes[k] = std::abs(scratch[k]) * scale;
+    }
+    return true;
+}
@@ -0,0 +1,65 @@
+#include "spectrum/sliding_dft.h"
+
+#include <algorithm>
+#include <cmath>
+
+SlidingDft::SlidingDft(std::size_t window, std::size_t bins){
+    Reset(window, bins);
+}
+
+SlidingDft::~SlidingDft(){}
+
+void SlidingDft::Push(float x){
+    float oldest = samples_[head_];
+    samples_[head_] = x;
+    head_ = (head_ + 1) % samples_.size();
+    if(size_ < samples_.size())
+        size_++;
+
+    double delta = (double)x - oldest;
+    for(std::size_t k = 0; k < bins_.size(); k++)
+        bins_[k] = (bins_[k] + delta) * twiddles_[k];
+
+    if(++since_recompute_ == samples_.size())
+        Recompute();
+}
+
+void SlidingDft::Reset(std::size_t window, std::size_t bins){
+    if(window < 1)
+        window = 1;
+    samples_.assign(window, 0);
+    bins_.assign(bins, 0);
+    twiddles_.resize(bins);
+    for(std::size_t k = 0; k < bins; k++)
+        twiddles_[k] = std::polar(1.0, 2 * M_PI * k / window);
+    Clear();
+}
+
+void SlidingDft::Clear(){
+    std::fill(samples_.begin(), samples_.end(), 0.0f);
+    std::fill(bins_.begin(), bins_.end(), 0.0);
+    head_ = 0;
+    size_ = 0;
+    since_recompute_ = 0;
+}
+
+float SlidingDft::Amplitude(std::size_t k) const {
+    double scale = (k == 0 ? 1.0 : 2.0) / samples_.size();
+    return (float)(std::abs(bins_[k]) * scale);
+}
+
+void SlidingDft::Recompute(){
+    // Same phase reference as the recursion, the oldest sample is x(0).
+    std::size_t window = samples_.size();
+    for(std::size_t k = 0; k < bins_.size(); k++){
+        std::complex<double> sum = 0;
+        std::complex<double> twiddle = 1;
+        std::complex<double> step = std::polar(1.0, -2 * M_PI * k / window);
+        for(std::size_t n = 0; n < window; n++){
+            sum += (double)samples_[(head_ + n) % window] * twiddle;
+            twiddle *= step;
+        }
+        bins_[k] = sum;
+    }
+    since_recompute_ = 0;
+}
@@ -0,0 +1,62 @@
+#include "spectrum/spectrum_analyzer.h"
+
+#include <spectrum/fft.h>
+
+#include <cmath>
+
+const std::size_t SpectrumAnalyzer::DEFAULT_HARMONICS;
+const std::size_t SpectrumAnalyzer::MAX_WINDOW;
+
+SpectrumAnalyzer::SpectrumAnalyzer(std::size_t harmonics) :
+        time_delta_(0),
+        fft_resolution_(0){
+    Configure(1, 0.001, harmonics);
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer(){}
+
+void SpectrumAnalyzer::Configure(float angular_velocity, double time_delta,
+                                 std::size_t harmonics){
+    time_delta_ = time_delta;
+
+    // A crank turning backwards has the same revolution length.
+    double speed = std::fabs(angular_velocity);
+    double revolution = speed > 0 ? 2 * M_PI / (speed * time_delta)
+                                  : MAX_WINDOW;
+    std::size_t window = (std::size_t)(revolution + 0.5);
+    if(window > MAX_WINDOW)
+        window = MAX_WINDOW;
+    // Harmonic k needs at least 2k + 1 samples per revolution.
+    if(window < 2 * harmonics + 1)
+        window = 2 * harmonics + 1;
+
+    for(int c = 0; c < HODOGRAPH_CHANNEL_COUNT; c++){
+        if(dfts_[c].window() != window || dfts_[c].bins() != harmonics + 1)
+            dfts_[c].Reset(window, harmonics + 1);
+    }
+}
+
+void SpectrumAnalyzer::Push(const HodographSample& sample){
+    dfts_[0].Push(sample.position.z);
+    dfts_[1].Push(sample.velocity.z);
+    dfts_[2].Push(sample.acceleration.z);
+}
+
+void SpectrumAnalyzer::Clear(){
+    for(int c = 0; c < HODOGRAPH_CHANNEL_COUNT; c++){
+        dfts_[c].Clear();
+        ffts_[c].clear();
+    }
+}
+
+bool SpectrumAnalyzer::UpdateFft(const HodographCache& cache,
+                                 std::size_t fft_size){
+    for(int c = 0; c < HODOGRAPH_CHANNEL_COUNT; c++){
+        RingView<float> samples = cache.View(static_cast<HodographChannel>(c),
+                                             Axis::Z);
+        if(!ComputeAmplitudeSpectrum(samples, fft_size, scratch_, ffts_[c]))
+            return false;
+    }
+    fft_resolution_ = (float)(1.0 / (fft_size * time_delta_));
+    return true;
+}
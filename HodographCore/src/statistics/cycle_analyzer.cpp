@@ -0,0 +1,73 @@
+#include "statistics/cycle_analyzer.h"
+
+#include <cmath>
+
+const std::size_t CycleAnalyzer::DEFAULT_HISTORY_CAPACITY;
+
+CycleAnalyzer::CycleAnalyzer(std::size_t history_capacity) :
+        history_(history_capacity){
+    Clear();
+}
+
+CycleAnalyzer::~CycleAnalyzer(){}
+
+void CycleAnalyzer::Push(double time, float alpha,
+                         const HodographSample& sample, float deviation){
+    if(!started_)
+        Start(time);
+
+    float position = sample.position.z;
+    float velocity = sample.velocity.z;
+    float acceleration = sample.acceleration.z;
+    float offset = (float)(time - current_.start_time);
+
+    if(current_.samples == 0 || position > current_.top_position){
+        current_.top_position = position;
+        current_.top_time = offset;
+    }
+    if(current_.samples == 0 || position < current_.bottom_position){
+        current_.bottom_position = position;
+        current_.bottom_time = offset;
+    }
+    if(current_.samples == 0
+       || std::fabs(velocity) > std::fabs(current_.peak_velocity)){
+        current_.peak_velocity = velocity;
+        current_.peak_velocity_alpha = alpha;
+    }
+    if(current_.samples == 0
+       || std::fabs(acceleration) > std::fabs(current_.peak_acceleration)){
+        current_.peak_acceleration = acceleration;
+        current_.peak_acceleration_alpha = alpha;
+    }
+    deviation_sum_sqr_ += (double)deviation * deviation;
+    current_.samples++;
+}
+
+bool CycleAnalyzer::Finish(double time){
+    if(!started_ || current_.samples == 0)
+        return false;
+
+    current_.period = (float)(time - current_.start_time);
+    current_.error_rms = (float)std::sqrt(deviation_sum_sqr_
+                                          / current_.samples);
+    current_.index = cycles_++;
+    history_.Push(current_);
+
+    Start(time);
+    return true;
+}
+
+void CycleAnalyzer::Clear(){
+    current_ = CycleRecord();
+    history_.Clear();
+    cycles_ = 0;
+    deviation_sum_sqr_ = 0;
+    started_ = false;
+}
+
+void CycleAnalyzer::Start(double time){
+    current_ = CycleRecord();
+    current_.start_time = time;
+    deviation_sum_sqr_ = 0;
+    started_ = true;
+}
@@ -0,0 +1,177 @@
+#include "statistics/phase_density.h"
+
+#include <algorithm>
+#include <cmath>
+
+const int PhaseDensity::DEFAULT_RESOLUTION;
+const int PhaseDensity::DEFAULT_LEVELS;
+const int PhaseDensity::MAX_LEVELS;
+const std::size_t PhaseDensity::DEFAULT_MAX_RUNS;
+
+namespace {
+
+/**
+ * Span of an axis after the first sample, relative to its magnitude.
+ */
+const float INITIAL_SPAN = 1e-3f;
+const float MIN_INITIAL_SPAN = 1e-6f;
+
+int EvenResolution(int resolution){
+    resolution = std::max(resolution, 2);
+    return resolution + (resolution & 1);
+}
+
+float InitialSpan(float value){
+    return std::max(std::fabs(value) * INITIAL_SPAN, MIN_INITIAL_SPAN);
+}
+
+int Cell(float value, float min, float span, int resolution){
+    int cell = (int)((value - min) / span * resolution);
+    return std::min(std::max(cell, 0), resolution - 1);
+}
+
+}
+
+PhaseDensity::PhaseDensity(int width, int height) :
+        width_(EvenResolution(width)),
+        height_(EvenResolution(height)),
+        cells_(width_ * height_, 0),
+        scratch_(width_ * height_, 0){
+    Clear();
+}
+
+PhaseDensity::~PhaseDensity(){}
+
+void PhaseDensity::Push(float x, float v){
+    if(std::isnan(x) || std::isnan(v) || std::isinf(x) || std::isinf(v))
+        return;
+    if(size_ == 0)
+        Start(x, v);
+
+    while(x < x_min_)
+        ExpandColumns(true);
+    while(x > x_min_ + x_span_)
+        ExpandColumns(false);
+    while(v < v_min_)
+        ExpandRows(true);
+    while(v > v_min_ + v_span_)
+        ExpandRows(false);
+
+    float& cell = cells_[Cell(v, v_min_, v_span_, height_) * width_
+                         + Cell(x, x_min_, x_span_, width_)];
+    cell += 1;
+    max_count_ = std::max(max_count_, cell);
+    size_++;
+}
+
+void PhaseDensity::Clear(){
+    std::fill(cells_.begin(), cells_.end(), 0.0f);
+    max_count_ = 0;
+    size_ = 0;
+    x_min_ = 0;
+    x_span_ = 1;
+    v_min_ = 0;
+    v_span_ = 1;
+}
+
+void PhaseDensity::Start(float x, float v){
+    x_span_ = InitialSpan(x);
+    x_min_ = x - x_span_ / 2;
+    v_span_ = InitialSpan(v);
+    v_min_ = v - v_span_ / 2;
+}
+
+void PhaseDensity::ExpandColumns(bool down){
+    // Cells 2k and 2k + 1 merge into one, the old grid takes the upper
+    // half when growing down and the lower half when growing up.
+    int shift = down ? width_ / 2 : 0;
+    std::fill(scratch_.begin(), scratch_.end(), 0.0f);
+    for(int row = 0; row < height_; row++){
+        const float* source = &cells_[row * width_];
+        float* target = &scratch_[row * width_];
+        for(int column = 0; column < width_; column++)
+            target[shift + column / 2] += source[column];
+    }
+    cells_.swap(scratch_);
+
+    if(down)
+        x_min_ -= x_span_;
+    x_span_ *= 2;
+    UpdateMaxCount();
+}
+
+void PhaseDensity::ExpandRows(bool down){
+    int shift = down ? height_ / 2 : 0;
+    std::fill(scratch_.begin(), scratch_.end(), 0.0f);
+    for(int row = 0; row < height_; row++){
+        const float* source = &cells_[row * width_];
+        float* target = &scratch_[(shift + row / 2) * width_];
+        for(int column = 0; column < width_; column++)
+            target[column] += source[column];
+    }
+    cells_.swap(scratch_);
+
+    if(down)
+        v_min_ -= v_span_;
+    v_span_ *= 2;
+    UpdateMaxCount();
+}
+
+void PhaseDensity::Runs(int levels, std::size_t max_runs,
+                        std::vector<DensityRun>& runs) const {
+    int block = 1;
+    do{
+        BlockRuns(levels, block, runs);
+        block *= 2;
+    }while(runs.size() > max_runs && block <= std::max(width_, height_));
+}
+
+void PhaseDensity::BlockRuns(int levels, int block,
+                             std::vector<DensityRun>& runs) const {
+    runs.clear();
+    if(max_count_ <= 0)
+        return;
+    // Level l holds means up to exp(l / scale) - 1, comparing against
+    // these thresholds saves a log per block. No mean exceeds max_count_.
+    levels = std::min(levels, MAX_LEVELS);
+    float scale = levels / std::log(1.0f + max_count_);
+    float thresholds[MAX_LEVELS];
+    for(int l = 0; l < levels - 1; l++)
+        thresholds[l] = std::exp((l + 1) / scale) - 1;
+    for(int row = 0; row < height_; row += block){
+        int rows = std::min(block, height_ - row);
+        DensityRun run = {row, rows, 0, 0, 0};
+        for(int column = 0; column <= width_; column += block){
+            int level = 0;
+            if(column < width_){
+                int columns = std::min(block, width_ - column);
+                float sum = 0;
+                for(int r = row; r < row + rows; r++){
+                    const float* cells = &cells_[r * width_ + column];
+                    for(int c = 0; c < columns; c++)
+                        sum += cells[c];
+                }
+                if(sum > 0){
+                    // Counted without branches, neighbouring levels of a
+                    // noisy grid are too random to predict.
+                    float mean = sum / (rows * columns);
+                    level = 1;
+                    for(int l = 0; l < levels - 1; l++)
+                        level += mean > thresholds[l];
+                }
+            }
+            if(column > 0 && level == run.level)
+                continue;
+            if(run.level > 0){
+                run.end = std::min(column, width_);
+                runs.push_back(run);
+            }
+            run.begin = column;
+            run.level = level;
+        }
+    }
+}
+
+void PhaseDensity::UpdateMaxCount(){
+    max_count_ = *std::max_element(cells_.begin(), cells_.end());
+}
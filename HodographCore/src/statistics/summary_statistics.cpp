@@ -0,0 +1,54 @@
+#include "statistics/summary_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+std::size_t PercentileIndex(float percentile, std::size_t count){
+    return (std::size_t)(percentile * (count - 1) + 0.5f);
+}
+
+}
+
+SummaryStatistics ComputeSummaryStatistics(const float* values,
+                                           std::size_t count,
+                                           std::vector<float>& scratch){
+    SummaryStatistics statistics;
+    if(scratch.size() < count)
+        scratch.resize(count);
+
+    double sum = 0;
+    double sum_sqr = 0;
+    std::size_t valid = 0;
+    for(std::size_t i = 0; i < count; i++){
+        float value = values[i];
+        if(std::isnan(value))
+            continue;
+        sum += value;
+        sum_sqr += (double)value * value;
+        scratch[valid++] = value;
+    }
+    statistics.invalid = count - valid;
+    if(valid == 0)
+        return statistics;
+
+    double mean = sum / valid;
+    statistics.mean = (float)mean;
+    statistics.variance = (float)std::max(0.0, sum_sqr / valid - mean * mean);
+
+    float* begin = scratch.data();
+    float* end = begin + valid;
+    std::size_t p50 = PercentileIndex(0.50f, valid);
+    std::size_t p05 = PercentileIndex(0.05f, valid);
+    std::size_t p95 = PercentileIndex(0.95f, valid);
+
+    std::nth_element(begin, begin + p50, end);
+    statistics.p50 = begin[p50];
+    std::nth_element(begin, begin + p05, begin + p50);
+    statistics.p05 = p05 < p50 ? begin[p05] : statistics.p50;
+    std::nth_element(begin + p50, begin + p95, end);
+    statistics.p95 = begin[p95];
+
+    return statistics;
+}
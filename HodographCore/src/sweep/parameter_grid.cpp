@@ -0,0 +1,24 @@
+#include "sweep/parameter_grid.h"
+
+ParameterGrid::ParameterGrid(const HodographParameters& parameters) :
+        angular_velocity(parameters.angular_velocity),
+        radius(parameters.radius),
+        line_length(parameters.line_length),
+        error(parameters.error){}
+
+std::size_t ParameterGrid::size() const {
+    return (std::size_t)angular_velocity.count * radius.count
+           * line_length.count * error.count;
+}
+
+HodographParameters ParameterGrid::At(std::size_t index) const {
+    HodographParameters parameters;
+    parameters.error = error.Value(index % error.count);
+    index /= error.count;
+    parameters.line_length = line_length.Value(index % line_length.count);
+    index /= line_length.count;
+    parameters.radius = radius.Value(index % radius.count);
+    index /= radius.count;
+    parameters.angular_velocity = angular_velocity.Value((int)index);
+    return parameters;
+}
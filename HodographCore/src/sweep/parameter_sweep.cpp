@@ -0,0 +1,100 @@
+#include "sweep/parameter_sweep.h"
+
+#include <kinematics/hodograph_kinematics.h>
+#include <threading/work_stealing_pool.h>
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+ParameterSweep::ParameterSweep(const ParameterGrid& grid,
+                               long long steps, float time_delta,
+                               uint64_t seed) :
+        grid_(grid),
+        steps_(steps),
+        time_delta_(time_delta),
+        seed_(seed),
+        derivative_method_(DerivativeMethod::FINITE_DIFFERENCE){}
+
+ParameterSweep::~ParameterSweep(){}
+
+void ParameterSweep::Run(WorkStealingPool& pool, ResultCallback callback,
+                         std::size_t chunk_size){
+    if(chunk_size == 0)
+        chunk_size = 1;
+    std::mutex callback_mutex;
+
+    std::size_t size = grid_.size();
+    for(std::size_t begin = 0; begin < size; begin += chunk_size){
+        std::size_t end = std::min(size, begin + chunk_size);
+        pool.Submit([this, begin, end, &callback, &callback_mutex](){
+            std::vector<SweepResult> results;
+            results.reserve(end - begin);
+            for(std::size_t i = begin; i < end; i++)
+                results.push_back(Evaluate(i));
+
+            std::lock_guard<std::mutex> lock(callback_mutex);
+            for(auto& result : results)
+                callback(result);
+        });
+    }
+    pool.Wait();
+}
+
+SweepResult ParameterSweep::Evaluate(std::size_t index) const {
+    SweepResult result;
+    result.index = index;
+    result.parameters = grid_.At(index);
+    result.buildable
+            = result.parameters.line_length >= result.parameters.radius;
+    result.invalid_steps = 0;
+    result.peak_acceleration = 0;
+    result.rms_acceleration = 0;
+    result.min_velocity = 0;
+    result.max_velocity = 0;
+    if(!result.buildable)
+        return result;
+
+    HodographKinematics kinematics(1);
+    kinematics.parameters(result.parameters);
+    kinematics.cache_enabled(false);
+    kinematics.statistics_enabled(false);
+    kinematics.derivative_method(derivative_method_);
+    kinematics.filter_settings(filter_settings_);
+    kinematics.noise_stream().Reset(seed_, index);
+
+    double acceleration_sqr_sum = 0;
+    long long valid_steps = 0;
+    float min_velocity = INFINITY;
+    float max_velocity = -INFINITY;
+    float peak_acceleration = 0;
+    for(long long step = 0; step < steps_; step++){
+        kinematics.Update(time_delta_);
+        if(!kinematics.sample_valid())
+            continue;
+
+        const HodographSample& sample = kinematics.sample();
+        float velocity = sample.velocity.z;
+        float acceleration = sample.acceleration.z;
+        if(std::isnan(velocity) || std::isnan(acceleration)){
+            result.invalid_steps++;
+            continue;
+        }
+        valid_steps++;
+        min_velocity = std::min(min_velocity, velocity);
+        max_velocity = std::max(max_velocity, velocity);
+        peak_acceleration = std::max(peak_acceleration,
+                                     std::fabs(acceleration));
+        acceleration_sqr_sum += (double)acceleration * acceleration;
+    }
+
+    if(valid_steps > 0){
+        result.peak_acceleration = peak_acceleration;
+        result.rms_acceleration
+                = (float)std::sqrt(acceleration_sqr_sum / valid_steps);
+        result.min_velocity = min_velocity;
+        result.max_velocity = max_velocity;
+    }
+    return result;
+}
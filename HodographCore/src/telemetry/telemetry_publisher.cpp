@@ -0,0 +1,110 @@
+#include "telemetry/telemetry_publisher.h"
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+const std::size_t TelemetryPublisher::DEFAULT_CAPACITY;
+
+namespace {
+
+uint64_t PowerOfTwo(std::size_t value){
+    uint64_t result = 1;
+    while(result < value)
+        result <<= 1;
+    return result;
+}
+
+}
+
+TelemetryPublisher::TelemetryPublisher() :
+        header_(nullptr),
+        slots_(nullptr),
+        length_(0),
+        mask_(0),
+        published_(0){}
+
+TelemetryPublisher::~TelemetryPublisher(){
+    Close();
+}
+
+bool TelemetryPublisher::Open(const std::string& name, std::size_t capacity){
+    Close();
+    error_.clear();
+
+    uint64_t slots = PowerOfTwo(capacity);
+    std::size_t length = TelemetrySize(slots);
+
+    // Readers of a previous run keep their object, this one starts empty.
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if(fd < 0){
+        SetError(name);
+        return false;
+    }
+    if(ftruncate(fd, length) != 0){
+        SetError(name);
+        close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    void* data = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      fd, 0);
+    close(fd);
+    if(data == MAP_FAILED){
+        SetError(name);
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    // ftruncate zero fills, every sequence starts at 0 = never written.
+    header_ = new(data) TelemetryHeader();
+    memcpy(header_->magic, TELEMETRY_MAGIC, sizeof(TELEMETRY_MAGIC));
+    header_->version = TELEMETRY_VERSION;
+    header_->record_size = sizeof(TraceRecord);
+    header_->capacity = slots;
+    header_->published.store(0, std::memory_order_relaxed);
+    header_->closed.store(0, std::memory_order_release);
+
+    slots_ = (TelemetrySlot*)((char*)data + sizeof(TelemetryHeader));
+    length_ = length;
+    mask_ = slots - 1;
+    published_ = 0;
+    name_ = name;
+    return true;
+}
+
+void TelemetryPublisher::Close(){
+    if(!header_)
+        return;
+    header_->closed.store(1, std::memory_order_release);
+    munmap(header_, length_);
+    shm_unlink(name_.c_str());
+
+    header_ = nullptr;
+    slots_ = nullptr;
+    length_ = 0;
+}
+
+void TelemetryPublisher::Publish(const TraceRecord& record){
+    if(!header_)
+        return;
+    uint64_t index = published_;
+    TelemetrySlot& slot = slots_[index & mask_];
+
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&slot.record, &record, sizeof(TraceRecord));
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+
+    published_ = index + 1;
+    header_->published.store(published_, std::memory_order_release);
+}
+
+void TelemetryPublisher::SetError(const std::string& message){
+    error_ = message + ": " + strerror(errno);
+}
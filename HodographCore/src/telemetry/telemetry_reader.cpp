@@ -0,0 +1,118 @@
+#include "telemetry/telemetry_reader.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+TelemetryReader::TelemetryReader() :
+        header_(nullptr),
+        slots_(nullptr),
+        length_(0),
+        cursor_(0),
+        lost_(0){}
+
+TelemetryReader::~TelemetryReader(){
+    Close();
+}
+
+bool TelemetryReader::Open(const std::string& name){
+    Close();
+    error_.clear();
+
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if(fd < 0){
+        error_ = name + ": " + strerror(errno);
+        return false;
+    }
+    struct stat info;
+    if(fstat(fd, &info) != 0){
+        error_ = name + ": " + strerror(errno);
+        close(fd);
+        return false;
+    }
+    if((std::size_t)info.st_size < sizeof(TelemetryHeader)){
+        error_ = name + ": not a telemetry ring";
+        close(fd);
+        return false;
+    }
+
+    length_ = info.st_size;
+    void* data = mmap(nullptr, length_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED){
+        error_ = name + ": " + strerror(errno);
+        return false;
+    }
+    header_ = (const TelemetryHeader*)data;
+
+    if(memcmp(header_->magic, TELEMETRY_MAGIC, sizeof(TELEMETRY_MAGIC)) != 0
+       || header_->version != TELEMETRY_VERSION
+       || header_->record_size != sizeof(TraceRecord)
+       || header_->capacity == 0
+       || TelemetrySize(header_->capacity) > length_){
+        error_ = name + ": not a telemetry ring or unsupported version";
+        Close();
+        return false;
+    }
+    slots_ = (const TelemetrySlot*)((const char*)data
+                                    + sizeof(TelemetryHeader));
+
+    cursor_ = published();
+    lost_ = 0;
+    return true;
+}
+
+void TelemetryReader::Close(){
+    if(header_)
+        munmap((void*)header_, length_);
+    header_ = nullptr;
+    slots_ = nullptr;
+    length_ = 0;
+}
+
+TelemetryRead TelemetryReader::Read(uint64_t index, TraceRecord& record){
+    const TelemetrySlot& slot = slots_[index % header_->capacity];
+    uint64_t expected = 2 * index + 2;
+
+    uint64_t before = slot.sequence.load(std::memory_order_acquire);
+    if(before != expected)
+        return before < expected ? TelemetryRead::NOT_PUBLISHED
+                                 : TelemetryRead::OVERWRITTEN;
+    // May race with the writer, the second load tells whether it did.
+    memcpy(&record, &slot.record, sizeof(TraceRecord));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t after = slot.sequence.load(std::memory_order_relaxed);
+    return after == expected ? TelemetryRead::OK : TelemetryRead::OVERWRITTEN;
+}
+
+std::size_t TelemetryReader::ReadNext(TraceRecord* records, uint64_t* indices,
+                                      std::size_t count){
+    std::size_t read = 0;
+    uint64_t end = published();
+    while(read < count && cursor_ < end){
+        // Records more than one ring behind are gone, do not try them.
+        if(end - cursor_ > header_->capacity){
+            lost_ += end - header_->capacity - cursor_;
+            cursor_ = end - header_->capacity;
+        }
+        switch(Read(cursor_, records[read])){
+            case TelemetryRead::OK:
+                if(indices)
+                    indices[read] = cursor_;
+                read++;
+                cursor_++;
+                break;
+            case TelemetryRead::OVERWRITTEN:
+                lost_++;
+                cursor_++;
+                break;
+            case TelemetryRead::NOT_PUBLISHED:
+                return read;
+        }
+    }
+    return read;
+}
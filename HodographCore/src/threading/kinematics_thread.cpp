@@ -0,0 +1,283 @@
+#include "threading/kinematics_thread.h"
+
+#include <profiling/profiler.h>
+
+#include <algorithm>
+#include <chrono>
+
+const std::size_t KinematicsThread::DEFAULT_QUEUE_CAPACITY;
+
+namespace {
+
+// Longest stretch of wall time caught up in one go after a stall.
+const double MAX_CATCH_UP_SECONDS = 0.1;
+const std::size_t CYCLE_QUEUE_CAPACITY = 256;
+
+}
+
+KinematicsThread::KinematicsThread(double rate, std::size_t queue_capacity) :
+        kinematics_(1),
+        linkage_(1),
+        time_(0),
+        settings_queue_(64),
+        frame_queue_(queue_capacity),
+        cycle_queue_(CYCLE_QUEUE_CAPACITY),
+        pushed_cycles_(0),
+        generation_(0),
+        statistics_generation_(0),
+        published_generation_(0),
+        // Nothing is published before the first tick.
+        published_statistics_generation_(~0u),
+        stop_(false),
+        running_(true),
+        resets_(0),
+        statistics_resets_(0),
+        rate_(rate),
+        fast_forward_(1),
+        dropped_frames_(0),
+        steps_(0){
+    kinematics_.cache_enabled(false);
+    kinematics_.cycles_enabled(true);
+    linkage_.cache_enabled(false);
+}
+
+KinematicsThread::~KinematicsThread(){
+    Stop();
+}
+
+void KinematicsThread::Start(){
+    if(thread_.joinable())
+        return;
+    stop_ = false;
+    thread_ = std::thread(&KinematicsThread::Run, this);
+}
+
+void KinematicsThread::Stop(){
+    stop_ = true;
+    if(thread_.joinable())
+        thread_.join();
+}
+
+void KinematicsThread::SetRate(double rate){
+    if(rate > 0)
+        rate_ = rate;
+}
+
+void KinematicsThread::SetFastForward(int factor){
+    if(factor > 0)
+        fast_forward_ = factor;
+}
+
+bool KinematicsThread::PushSettings(const HodographSettings& settings){
+    return settings_queue_.TryPush(settings);
+}
+
+bool KinematicsThread::PopFrame(HodographFrame& frame){
+    uint32_t generation = resets_;
+    while(frame_queue_.TryPop(frame)){
+        if(frame.generation == generation)
+            return true;
+    }
+    return false;
+}
+
+bool KinematicsThread::PopCycle(CycleRecord& cycle){
+    uint32_t generation = resets_;
+    QueuedCycle queued;
+    while(cycle_queue_.TryPop(queued)){
+        if(queued.generation == generation){
+            cycle = queued.record;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool KinematicsThread::ReadStatistics(HodographStatistics& statistics){
+    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    if(published_generation_ != resets_
+       || published_statistics_generation_ != statistics_resets_)
+        return false;
+    statistics = published_statistics_;
+    return true;
+}
+
+void KinematicsThread::Run(){
+    typedef std::chrono::steady_clock Clock;
+    Profiler::SetThreadName("Kinematics");
+
+    double rate = rate_;
+    Clock::time_point start = Clock::now();
+    long long ticks = 0;
+
+    while(!stop_){
+        HodographSettings settings;
+        while(settings_queue_.TryPop(settings))
+            ApplySettings(settings);
+
+        uint32_t resets = resets_;
+        if(resets != generation_){
+            kinematics_ = HodographKinematics(1);
+            kinematics_.cache_enabled(false);
+            kinematics_.cycles_enabled(true);
+            linkage_ = LinkageKinematics(1);
+            linkage_.cache_enabled(false);
+            linkage_statistics_.Clear();
+            ApplySettings(settings_);
+            pushed_cycles_ = 0;
+            generation_ = resets;
+            time_ = 0;
+            steps_ = 0;
+        }
+        uint32_t statistics_resets = statistics_resets_;
+        if(statistics_resets != statistics_generation_){
+            kinematics_.ResetStatistics();
+            linkage_statistics_.Clear();
+            statistics_generation_ = statistics_resets;
+        }
+
+        if(rate != rate_ || !running_){
+            // Restart the schedule, the old one no longer applies.
+            rate = rate_;
+            start = Clock::now();
+            ticks = 0;
+        }
+
+        std::chrono::duration<double> elapsed = Clock::now() - start;
+        long long due = (long long)(elapsed.count() * rate);
+        long long max_steps = (long long)(MAX_CATCH_UP_SECONDS * rate) + 1;
+        if(due - ticks > max_steps)
+            ticks = due - max_steps;
+
+        float time_delta = (float)(1.0 / rate);
+        for(; ticks < due; ticks++){
+            // Publish step 0 alone, the first frame shows alpha = 0.
+            if(running_)
+                Step(time_delta, steps_ == 0 ? 1 : fast_forward_.load());
+        }
+        PublishStatistics();
+
+        std::this_thread::sleep_until(
+                start + std::chrono::duration_cast<Clock::duration>(
+                        std::chrono::duration<double>((ticks + 1) / rate)));
+    }
+}
+
+void KinematicsThread::Step(float time_delta, int count){
+    // One scope per tick, the stages of every step are only recorded
+    // while Profiler::detailed() is set.
+    ProfileScope scope("KinematicsStep");
+    HodographFrame frame;
+    if(settings_.mechanism.type != MechanismType::CRANK_SLIDER){
+        StepLinkage(time_delta, count, frame);
+        if(!frame_queue_.TryPush(frame))
+            dropped_frames_++;
+        return;
+    }
+
+    if(count > 1){
+        kinematics_.Step(count - 1, time_delta, nullptr);
+        time_ += (count - 1) * (double)time_delta;
+        steps_ += count - 1;
+    }
+    kinematics_.Update(time_delta);
+    time_ += time_delta;
+
+    frame.generation = generation_;
+    frame.step = steps_++;
+    frame.time = time_;
+    frame.frame_interval = count * (double)time_delta;
+    frame.angular_velocity = settings_.parameters.angular_velocity;
+    frame.alpha = kinematics_.alpha();
+    frame.line_error_length = kinematics_.line_error_length();
+    frame.position0 = kinematics_.line().position0;
+    frame.position1 = kinematics_.line().position1;
+    frame.sample = kinematics_.sample();
+    frame.sample_valid = kinematics_.sample_valid();
+    frame.derivative_difference = kinematics_.derivative_difference();
+    frame.sensitivity = kinematics_.sensitivity();
+    frame.linkage_status = LinkageStatus::OK;
+    frame.linkage_iterations = 0;
+
+    if(!frame_queue_.TryPush(frame))
+        dropped_frames_++;
+    PushCycles();
+}
+
+void KinematicsThread::StepLinkage(float time_delta, int count,
+                                   HodographFrame& frame){
+    for(int i = 0; i < count; i++){
+        linkage_.Update(time_delta);
+        linkage_statistics_.Push(linkage_.sample(),
+                                 time_ + (i + 1) * (double)time_delta);
+    }
+    time_ += count * (double)time_delta;
+    steps_ += count - 1;
+
+    frame.generation = generation_;
+    frame.step = steps_++;
+    frame.time = time_;
+    frame.frame_interval = count * (double)time_delta;
+    frame.angular_velocity = settings_.parameters.angular_velocity;
+    frame.alpha = linkage_.alpha();
+    frame.line_error_length = linkage_.line_error_length();
+    frame.position0 = linkage_.position0();
+    frame.position1 = linkage_.sample().position;
+    frame.sample = linkage_.sample();
+    frame.sample_valid = true;
+    frame.derivative_difference = HodographSample();
+    frame.sensitivity = HodographSensitivity();
+    frame.linkage_status = linkage_.status();
+    frame.linkage_iterations = linkage_.iterations();
+}
+
+void KinematicsThread::PushCycles(){
+    const CycleAnalyzer& cycles = kinematics_.cycles();
+    uint32_t count = cycles.cycles();
+    if(count == pushed_cycles_)
+        return;
+
+    // A long fast-forward may finish more revolutions than the history
+    // keeps, the oldest of them are lost.
+    const RingBuffer<CycleRecord>& history = cycles.history();
+    std::size_t fresh = std::min<std::size_t>(count - pushed_cycles_,
+                                              history.size());
+    for(std::size_t i = history.size() - fresh; i < history.size(); i++){
+        QueuedCycle queued;
+        queued.generation = generation_;
+        queued.record = history[i];
+        cycle_queue_.TryPush(queued);
+    }
+    pushed_cycles_ = count;
+}
+
+void KinematicsThread::PublishStatistics(){
+    std::unique_lock<std::mutex> lock(statistics_mutex_, std::try_to_lock);
+    if(!lock.owns_lock())
+        return;
+    published_statistics_
+            = settings_.mechanism.type == MechanismType::CRANK_SLIDER
+              ? kinematics_.statistics() : linkage_statistics_;
+    published_generation_ = generation_;
+    published_statistics_generation_ = statistics_generation_;
+}
+
+void KinematicsThread::ApplySettings(const HodographSettings& settings){
+    settings_ = settings;
+    kinematics_.parameters(settings.parameters);
+    kinematics_.derivative_method(settings.derivative_method);
+    kinematics_.diagnostics_enabled(settings.diagnostics_enabled);
+    kinematics_.sensitivity_enabled(settings.sensitivity_enabled);
+    kinematics_.filter_settings(settings.filter);
+    linkage_.parameters(settings.parameters);
+    linkage_.mechanism(settings.mechanism);
+
+    NoiseStream& noise_stream = kinematics_.noise_stream();
+    if(noise_stream.seed() != settings.seed)
+        noise_stream.Reset(settings.seed, noise_stream.stream());
+    NoiseStream& linkage_noise_stream = linkage_.noise_stream();
+    if(linkage_noise_stream.seed() != settings.seed){
+        linkage_noise_stream.Reset(settings.seed,
+                                   linkage_noise_stream.stream());
+    }
+}
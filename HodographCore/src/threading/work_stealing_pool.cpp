@@ -0,0 +1,95 @@
+#include "threading/work_stealing_pool.h"
+
+WorkStealingPool::WorkStealingPool(unsigned int thread_count) :
+        queued_(0),
+        pending_(0),
+        next_queue_(0),
+        stop_(false){
+    if(thread_count == 0)
+        thread_count = std::thread::hardware_concurrency();
+    if(thread_count == 0)
+        thread_count = 1;
+
+    for(unsigned int i = 0; i < thread_count; i++)
+        queues_.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+    for(unsigned int i = 0; i < thread_count; i++)
+        workers_.push_back(std::thread(&WorkStealingPool::Work, this, i));
+}
+
+WorkStealingPool::~WorkStealingPool(){
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    task_condition_.notify_all();
+    for(auto& worker : workers_)
+        worker.join();
+}
+
+void WorkStealingPool::Submit(Task task){
+    unsigned int index;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        index = next_queue_;
+        next_queue_ = (next_queue_ + 1) % queues_.size();
+        pending_++;
+    }
+    {
+        // Counted before Pop and Steal can see the task, they decrement
+        // under the same queue lock, so queued_ never underflows.
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+        std::lock_guard<std::mutex> count_lock(mutex_);
+        queued_++;
+    }
+    task_condition_.notify_one();
+}
+
+void WorkStealingPool::Wait(){
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_condition_.wait(lock, [this]{return pending_ == 0;});
+}
+
+void WorkStealingPool::Work(unsigned int index){
+    while(true){
+        Task task;
+        if(Pop(index, task) || Steal(index, task)){
+            task();
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if(--pending_ == 0)
+                done_condition_.notify_all();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        task_condition_.wait(lock, [this]{return queued_ > 0 || stop_;});
+        if(stop_ && queued_ == 0)
+            return;
+    }
+}
+
+bool WorkStealingPool::Pop(unsigned int index, Task& task){
+    WorkerQueue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if(queue.tasks.empty())
+        return false;
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    queued_--;
+    return true;
+}
+
+bool WorkStealingPool::Steal(unsigned int index, Task& task){
+    for(std::size_t i = 1; i < queues_.size(); i++){
+        WorkerQueue& queue = *queues_[(index + i) % queues_.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if(queue.tasks.empty())
+            continue;
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        queued_--;
+        return true;
+    }
+    return false;
+}
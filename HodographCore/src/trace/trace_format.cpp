@@ -0,0 +1,38 @@
+#include "trace/trace_format.h"
+
+#include <cstring>
+
+TraceHeader CreateTraceHeader(const HodographParameters& parameters,
+                              uint64_t seed){
+    TraceHeader header = TraceHeader();
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_VERSION;
+    header.record_size = sizeof(TraceRecord);
+    header.parameters = parameters;
+    header.seed = seed;
+    header.record_count = 0;
+    return header;
+}
+
+TraceRecord CreateTraceRecord(double time, float alpha,
+                              float line_error_length,
+                              const Vec3& position0,
+                              const HodographSample& sample){
+    TraceRecord record;
+    record.time = time;
+    record.alpha = alpha;
+    record.line_error_length = line_error_length;
+    record.position0 = position0;
+    record.position = sample.position;
+    record.velocity = sample.velocity;
+    record.acceleration = sample.acceleration;
+    return record;
+}
+
+HodographSample GetTraceSample(const TraceRecord& record){
+    HodographSample sample;
+    sample.position = record.position;
+    sample.velocity = record.velocity;
+    sample.acceleration = record.acceleration;
+    return sample;
+}
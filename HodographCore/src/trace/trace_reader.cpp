@@ -0,0 +1,72 @@
+#include "trace/trace_reader.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+TraceReader::TraceReader() :
+        data_(nullptr),
+        length_(0),
+        size_(0){}
+
+TraceReader::~TraceReader(){
+    Close();
+}
+
+bool TraceReader::Open(const std::string& path){
+    Close();
+    error_.clear();
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0){
+        error_ = path + ": " + strerror(errno);
+        return false;
+    }
+    struct stat info;
+    if(fstat(fd, &info) != 0){
+        error_ = path + ": " + strerror(errno);
+        close(fd);
+        return false;
+    }
+    if((std::size_t)info.st_size < sizeof(TraceHeader)){
+        error_ = path + ": not a trace file";
+        close(fd);
+        return false;
+    }
+
+    length_ = info.st_size;
+    void* data = mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED){
+        error_ = path + ": " + strerror(errno);
+        return false;
+    }
+    data_ = data;
+
+    const TraceHeader& trace_header = header();
+    if(memcmp(trace_header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0
+       || trace_header.version != TRACE_VERSION
+       || trace_header.record_size != sizeof(TraceRecord)){
+        error_ = path + ": not a trace file or unsupported version";
+        Close();
+        return false;
+    }
+
+    // A writer that did not finish may leave a stale count, trust the size.
+    size_ = (length_ - sizeof(TraceHeader)) / sizeof(TraceRecord);
+
+    madvise(data_, length_, MADV_SEQUENTIAL);
+    return true;
+}
+
+void TraceReader::Close(){
+    if(data_)
+        munmap(data_, length_);
+    data_ = nullptr;
+    length_ = 0;
+    size_ = 0;
+}
@@ -0,0 +1,141 @@
+#include "trace/trace_writer.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+const std::size_t TraceWriter::DEFAULT_QUEUE_CAPACITY;
+
+namespace {
+
+const std::size_t WRITE_BLOCK = 4096;
+
+bool WriteAll(int fd, const char* data, std::size_t size){
+    while(size > 0){
+        ssize_t written = write(fd, data, size);
+        if(written < 0){
+            if(errno == EINTR)
+                continue;
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+}
+
+TraceWriter::TraceWriter(std::size_t queue_capacity) :
+        fd_(-1),
+        queue_(queue_capacity),
+        stop_(false),
+        written_(0),
+        dropped_(0){}
+
+TraceWriter::~TraceWriter(){
+    Close();
+}
+
+bool TraceWriter::Open(const std::string& path, const TraceHeader& header){
+    Close();
+    {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        error_.clear();
+    }
+
+    fd_ = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd_ < 0){
+        SetError(path);
+        return false;
+    }
+    header_ = header;
+    header_.record_count = 0;
+    if(!WriteAll(fd_, (const char*)&header_, sizeof(header_))){
+        SetError(path);
+        close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    written_ = 0;
+    dropped_ = 0;
+    stop_ = false;
+    thread_ = std::thread(&TraceWriter::Run, this);
+    return true;
+}
+
+void TraceWriter::Close(){
+    if(fd_ < 0)
+        return;
+    stop_ = true;
+    if(thread_.joinable())
+        thread_.join();
+    close(fd_);
+    fd_ = -1;
+}
+
+bool TraceWriter::Append(const TraceRecord& record){
+    if(queue_.TryPush(record))
+        return true;
+    dropped_++;
+    return false;
+}
+
+bool TraceWriter::AppendBlocking(const TraceRecord& record){
+    if(fd_ < 0)
+        return false;
+    while(!queue_.TryPush(record))
+        std::this_thread::yield();
+    return true;
+}
+
+std::string TraceWriter::error(){
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    return error_;
+}
+
+void TraceWriter::Run(){
+    std::vector<TraceRecord> block(WRITE_BLOCK);
+    bool failed = false;
+
+    while(true){
+        bool stopping = stop_;
+        std::size_t count = 0;
+        while(count < WRITE_BLOCK && queue_.TryPop(block[count]))
+            count++;
+
+        if(count > 0 && !failed)
+            failed = !Flush(block.data(), count);
+        if(count == WRITE_BLOCK)
+            continue;
+        if(stopping)
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+bool TraceWriter::Flush(const TraceRecord* records, std::size_t count){
+    if(!WriteAll(fd_, (const char*)records, count * sizeof(TraceRecord))){
+        SetError("write");
+        return false;
+    }
+    written_ += count;
+
+    header_.record_count = written_;
+    if(pwrite(fd_, &header_, sizeof(header_), 0) != sizeof(header_)){
+        SetError("write header");
+        return false;
+    }
+    return true;
+}
+
+void TraceWriter::SetError(const std::string& message){
+    std::string error = message + ": " + strerror(errno);
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    error_ = error;
+}
@@ -0,0 +1,148 @@
+#include <telemetry/telemetry_reader.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+namespace {
+
+const std::size_t READ_BLOCK = 1024;
+
+struct TailOptions{
+    std::string name = TELEMETRY_DEFAULT_NAME;
+    /**
+     * Start at the oldest record still in the ring instead of the newest.
+     */
+    bool all = false;
+    /**
+     * Records to print before exiting, 0 follows until the writer closes.
+     */
+    long long count = 0;
+    int poll_ms = 1;
+};
+
+void PrintTailUsage(const char* program){
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --name NAME              shared memory object "
+            "(default: %s)\n"
+            "  --all                    start at the oldest record "
+            "still in the ring\n"
+            "  --count N                exit after N records "
+            "(default: follow)\n"
+            "  --poll MS                sleep between polls "
+            "(default: 1)\n",
+            program, TELEMETRY_DEFAULT_NAME);
+}
+
+bool ParseTailOptions(int argc, char** argv, TailOptions& options){
+    for(int i = 1; i < argc; i++){
+        const char* name = argv[i];
+        if(strcmp(name, "--help") == 0 || strcmp(name, "-h") == 0){
+            PrintTailUsage(argv[0]);
+            return false;
+        }
+        if(strcmp(name, "--all") == 0){
+            options.all = true;
+            continue;
+        }
+        if(i + 1 >= argc){
+            fprintf(stderr, "Missing value for %s\n", name);
+            PrintTailUsage(argv[0]);
+            return false;
+        }
+        const char* value = argv[++i];
+        char* end = nullptr;
+
+        bool valid = true;
+        if(strcmp(name, "--name") == 0){
+            options.name = value;
+        }else if(strcmp(name, "--count") == 0){
+            options.count = strtoll(value, &end, 10);
+            valid = end != value && *end == '\0' && options.count >= 0;
+        }else if(strcmp(name, "--poll") == 0){
+            options.poll_ms = (int)strtol(value, &end, 10);
+            valid = end != value && *end == '\0' && options.poll_ms >= 0;
+        }else{
+            fprintf(stderr, "Unknown option %s\n", name);
+            PrintTailUsage(argv[0]);
+            return false;
+        }
+
+        if(!valid){
+            fprintf(stderr, "Invalid value for %s: %s\n", name, value);
+            return false;
+        }
+    }
+    return true;
+}
+
+void WriteHeader(FILE* file){
+    fprintf(file, "step,time,alpha,line_error_length,"
+            "position_x,position_y,position_z,"
+            "velocity_x,velocity_y,velocity_z,"
+            "acceleration_x,acceleration_y,acceleration_z\n");
+}
+
+void WriteRecord(FILE* file, uint64_t step, const TraceRecord& record){
+    fprintf(file, "%llu,%.9g,%.9g,%.9g,"
+                    "%.9g,%.9g,%.9g,"
+                    "%.9g,%.9g,%.9g,"
+                    "%.9g,%.9g,%.9g\n",
+            (unsigned long long)step, record.time, record.alpha,
+            record.line_error_length,
+            record.position.x, record.position.y, record.position.z,
+            record.velocity.x, record.velocity.y, record.velocity.z,
+            record.acceleration.x, record.acceleration.y,
+            record.acceleration.z);
+}
+
+}
+
+int main(int argc, char** argv) {
+    TailOptions options;
+    if(!ParseTailOptions(argc, argv, options))
+        return 1;
+
+    TelemetryReader reader;
+    if(!reader.Open(options.name)){
+        fprintf(stderr, "%s\n", reader.error().c_str());
+        return 1;
+    }
+    if(options.all){
+        uint64_t published = reader.published();
+        reader.cursor(published > reader.capacity()
+                      ? published - reader.capacity() : 0);
+    }
+
+    TraceRecord records[READ_BLOCK];
+    uint64_t indices[READ_BLOCK];
+    long long printed = 0;
+
+    WriteHeader(stdout);
+    while(options.count == 0 || printed < options.count){
+        // Check before reading so the last records are not missed.
+        bool closed = reader.is_closed();
+        std::size_t read = reader.ReadNext(records, indices, READ_BLOCK);
+        for(std::size_t i = 0; i < read; i++){
+            if(options.count > 0 && printed == options.count)
+                break;
+            WriteRecord(stdout, indices[i], records[i]);
+            printed++;
+        }
+        if(read > 0)
+            fflush(stdout);
+        else if(closed)
+            break;
+        else
+            std::this_thread::sleep_for(
+                    std::chrono::milliseconds(options.poll_ms));
+    }
+
+    if(reader.lost() > 0)
+        fprintf(stderr, "# lost=%llu\n", reader.lost());
+    return 0;
+}